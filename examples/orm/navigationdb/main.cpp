@@ -99,10 +99,8 @@ int main(int argc, char* argv[])
             new Community{"Weitra", lowerAustria, "3970", 4092, 48.701348, 14.897371}};
         lowerAustria->setCommunityList(lowerAustrianCommunities);
 
-        session.merge(upperAustria,
-                      lowerAustria,
-                      upperAustrianCommunities,
-                      lowerAustrianCommunities);
+        session.mergeGraph(upperAustria);
+        session.mergeGraph(lowerAustria);
     }
     qDebug() << "Elapsed:" << timer.elapsed();
 
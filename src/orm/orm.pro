@@ -16,18 +16,26 @@ PUBLIC_HEADERS += \
     qormmetadata.h \
     qormmetadatacache.h \
     qormorder.h \
+    qormpreparedquery.h \
     qormpropertymapping.h \
     qormquery.h \
     qormquerybuilder.h \
+    qormquerycache.h \
+    qormqueryparameter.h \
     qormqueryresult.h \
     qormrelation.h \
+    qormrowset.h \
     qormsession.h \
     qormsessionconfiguration.h \
+    qormsessionstatistics.h \
     qormsqliteconfiguration.h \
     qormsqliteprovider.h \
+    qormtracer.h \
     qormtransactiontoken.h \
+    qormvalueresult.h \
 
 PRIVATE_HEADERS = \
+    qormcrossreferencevalidator_p.h \
     qormglobal_p.h \
     qormmetadata_p.h \
     qormsqlitestatementgenerator_p.h \
@@ -35,6 +43,7 @@ PRIVATE_HEADERS = \
 SOURCES += \
     qormabstractprovider.cpp \
     qormclassproperty.cpp \
+    qormcrossreferencevalidator_p.cpp \
     qormentityinstancecache.cpp \
     qormentitylistmodel.cpp \
     qormerror.cpp \
@@ -45,16 +54,22 @@ SOURCES += \
     qormmetadata.cpp \
     qormmetadatacache.cpp \
     qormorder.cpp \
+    qormpreparedquery.cpp \
     qormpropertymapping.cpp \
     qormquery.cpp \
     qormquerybuilder.cpp \
+    qormquerycache.cpp \
+    qormqueryparameter.cpp \
     qormqueryresult.cpp \
     qormrelation.cpp \
+    qormrowset.cpp \
     qormsession.cpp \
     qormsessionconfiguration.cpp \
+    qormsessionstatistics.cpp \
     qormsqliteconfiguration.cpp \
     qormsqliteprovider.cpp \
     qormsqlitestatementgenerator_p.cpp \
+    qormtracer.cpp \
     qormtransactiontoken.cpp \
 
 HEADERS += $$PUBLIC_HEADERS $$PRIVATE_HEADERS
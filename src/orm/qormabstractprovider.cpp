@@ -19,9 +19,45 @@
  */
 
 #include "qormabstractprovider.h"
+#include "qormquery.h"
 
 QT_BEGIN_NAMESPACE
 
+QOrmPreparedStatement::~QOrmPreparedStatement() = default;
+
 QOrmAbstractProvider::~QOrmAbstractProvider() = default;
 
+QOrmQueryResult<QObject> QOrmAbstractProvider::executeBatch(
+    QOrm::Operation operation,
+    const QOrmMetadata& entity,
+    const QVector<QObject*>& entityInstances,
+    QOrmEntityInstanceCache& entityInstanceCache)
+{
+    QVariantList objectIds;
+    objectIds.reserve(entityInstances.size());
+
+    for (QObject* entityInstance : entityInstances)
+    {
+        QOrmQueryResult<QObject> result =
+            execute(QOrmQuery{operation, entity, entityInstance}, entityInstanceCache);
+
+        if (result.error().type() != QOrm::ErrorType::None)
+            return result;
+
+        objectIds.push_back(result.lastInsertedId());
+    }
+
+    return QOrmQueryResult<QObject>{QVariant{objectIds}};
+}
+
+QOrmSessionStatistics* QOrmAbstractProvider::statistics() const
+{
+    return m_statistics;
+}
+
+void QOrmAbstractProvider::setStatistics(QOrmSessionStatistics* statistics)
+{
+    m_statistics = statistics;
+}
+
 QT_END_NAMESPACE
@@ -23,14 +23,31 @@
 
 #include <QtOrm/qormglobal.h>
 #include <QtOrm/qormqueryresult.h>
+#include <QtOrm/qormrowset.h>
+
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+#include <memory>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
 class QObject;
 class QOrmEntityInstanceCache;
 class QOrmError;
+class QOrmMetadata;
 class QOrmMetadataCache;
+class QOrmPropertyMapping;
 class QOrmQuery;
+class QOrmSessionStatistics;
+
+// Backend representation of a query rendered once and executed with different parameter values
+class Q_ORM_EXPORT QOrmPreparedStatement
+{
+public:
+    virtual ~QOrmPreparedStatement();
+};
 
 class Q_ORM_EXPORT QOrmAbstractProvider
 {
@@ -47,6 +64,37 @@ public:
 
     virtual QOrmQueryResult<QObject> execute(const QOrmQuery& query,
                                              QOrmEntityInstanceCache& entityInstanceCache) = 0;
+
+    // Reads the values of the columns of the property mappings without hydrating entity instances
+    virtual QOrmRowSet executeRowSet(const QOrmQuery& query,
+                                     const std::vector<QOrmPropertyMapping>& columns) = 0;
+
+    // Inserts the rows of a row set with the non-autogenerated columns of the entity in the
+    // order of its property mappings
+    virtual QOrmError insertRowSet(const QOrmMetadata& entity, const QOrmRowSet& rowSet) = 0;
+
+    virtual std::unique_ptr<QOrmPreparedStatement> prepare(const QOrmQuery& query) = 0;
+
+    // The values of QOrmQueryParameter placeholders are looked up by their names
+    virtual QOrmQueryResult<QObject> execute(QOrmPreparedStatement& statement,
+                                             const QVariantMap& parameterValues,
+                                             QOrmEntityInstanceCache& entityInstanceCache) = 0;
+
+    // Creates, updates or upserts (QOrm::Operation::Merge) entity instances of one entity. The
+    // last inserted ID of the result is a list with the object IDs of the instances in their
+    // order. The default implementation executes a query per instance.
+    virtual QOrmQueryResult<QObject> executeBatch(QOrm::Operation operation,
+                                                  const QOrmMetadata& entity,
+                                                  const QVector<QObject*>& entityInstances,
+                                                  QOrmEntityInstanceCache& entityInstanceCache);
+
+    // Statistics the executed statements are recorded in, if set. See QOrmSession::statistics().
+    Q_REQUIRED_RESULT
+    QOrmSessionStatistics* statistics() const;
+    void setStatistics(QOrmSessionStatistics* statistics);
+
+private:
+    QOrmSessionStatistics* m_statistics{nullptr};
 };
 
 QT_END_NAMESPACE
@@ -27,6 +27,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QOrmFilterTerminalPredicate;
+
 class Q_ORM_EXPORT QOrmClassProperty
 {
 public:
@@ -34,6 +36,13 @@ public:
 
     QString descriptor() const;
 
+    // Defined in qormfilterexpression.h
+    template<typename Container>
+    QOrmFilterTerminalPredicate in(const Container& values) const;
+
+    template<typename Container>
+    QOrmFilterTerminalPredicate notIn(const Container& values) const;
+
 private:
     QString m_descriptor;
 };
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qormcrossreferencevalidator_p.h"
+
+#include "qormglobal_p.h"
+#include "qormmetadata.h"
+#include "qormpropertymapping.h"
+
+#include <QDebug>
+#include <QHash>
+#include <QMetaMethod>
+#include <QObject>
+#include <QSet>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmCrossReferenceValidatorPrivate : public QObject
+{
+    Q_OBJECT
+
+    friend class QOrmCrossReferenceValidator;
+
+    using InstanceSet = QSet<const QObject*>;
+
+    const InstanceSet& backReferencedInstances(const QObject* instance,
+                                               const QOrmPropertyMapping& backReference);
+
+private slots:
+    void onInstanceChanged();
+
+private:
+    // instances listed in the one-to-many back-references of an instance
+    QHash<const QObject*, QHash<const QOrmPropertyMapping*, InstanceSet>> m_backReferences;
+};
+
+const QOrmCrossReferenceValidatorPrivate::InstanceSet&
+QOrmCrossReferenceValidatorPrivate::backReferencedInstances(
+    const QObject* instance,
+    const QOrmPropertyMapping& backReference)
+{
+    auto* owner = const_cast<QObject*>(instance);
+    auto instanceIt = m_backReferences.find(instance);
+
+    if (instanceIt == std::end(m_backReferences))
+    {
+        instanceIt = m_backReferences.insert(instance, {});
+        // forget the lists of an instance when it is destroyed: its address can be reused
+        connect(owner,
+                &QObject::destroyed,
+                this,
+                &QOrmCrossReferenceValidatorPrivate::onInstanceChanged);
+    }
+
+    auto it = instanceIt->find(&backReference);
+
+    if (it == instanceIt->end())
+    {
+        const QVector<QObject*> instances =
+            QOrmPrivate::propertyValue(instance, backReference).value<QVector<QObject*>>();
+
+        InstanceSet instanceSet;
+        instanceSet.reserve(instances.size());
+
+        for (const QObject* listedInstance : instances)
+            instanceSet.insert(listedInstance);
+
+        it = instanceIt->insert(&backReference, instanceSet);
+
+        // ... and when any of them changes
+        int slotIndex = staticMetaObject.indexOfSlot("onInstanceChanged()");
+        connect(owner,
+                backReference.qMetaProperty().notifySignal(),
+                this,
+                staticMetaObject.method(slotIndex));
+    }
+
+    return it.value();
+}
+
+void QOrmCrossReferenceValidatorPrivate::onInstanceChanged()
+{
+    sender()->disconnect(this);
+    m_backReferences.remove(sender());
+}
+
+QOrmCrossReferenceValidator::QOrmCrossReferenceValidator()
+    : d{new QOrmCrossReferenceValidatorPrivate}
+{
+}
+
+QOrmCrossReferenceValidator::~QOrmCrossReferenceValidator() = default;
+
+std::optional<QString> QOrmCrossReferenceValidator::validate(const QOrmMetadata& entity,
+                                                             const QObject* entityInstance)
+{
+    using QOrmPrivate::entityInstanceRepresentation;
+    using QOrmPrivate::propertyValue;
+    using QOrmPrivate::shortPropertyMappingRepresentation;
+
+    for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+    {
+        if (!mapping.isReference())
+            continue;
+
+        Q_ASSERT(mapping.referencedEntity() != nullptr);
+
+        const QOrmPropertyMapping* backReference = mapping.backReference();
+        if (backReference == nullptr)
+            continue;
+
+        Q_ASSERT(backReference->referencedEntity()->className() == entity.className());
+
+        // if reference to a single instance, make sure that our instance is listed on the other
+        // side
+        if (!mapping.isTransient())
+        {
+            QObject* referencedEntity = propertyValue(entityInstance, mapping).value<QObject*>();
+
+            if (referencedEntity == nullptr)
+                continue;
+
+            // T* <-> QVector<T*>
+            // Check that the right side contains a reference to this entity instance
+            if (backReference->isTransient())
+            {
+                if (!d->backReferencedInstances(referencedEntity, *backReference)
+                         .contains(entityInstance))
+                {
+                    QString errorText;
+                    QDebug dbg{&errorText};
+                    dbg.noquote().nospace()
+                        << entityInstanceRepresentation(entity, entityInstance)
+                        << " references "
+                        << entityInstanceRepresentation(*mapping.referencedEntity(),
+                                                        referencedEntity)
+                        << " but its back-reference "
+                        << shortPropertyMappingRepresentation(*backReference)
+                        << " does not contain the original instance. ";
+                    return std::make_optional(errorText);
+                }
+            }
+            // T* <-> T*
+            // check that both sides are equal
+            else
+            {
+                QObject* backReferencedInstance =
+                    propertyValue(referencedEntity, *backReference).value<QObject*>();
+
+                if (backReferencedInstance != entityInstance)
+                {
+                    QString errorText;
+                    QDebug dbg{&errorText};
+                    dbg.noquote().nospace()
+                        << entityInstanceRepresentation(entity, entityInstance)
+                        << " references "
+                        << entityInstanceRepresentation(*mapping.referencedEntity(),
+                                                        referencedEntity)
+                        << " but its back-reference "
+                        << shortPropertyMappingRepresentation(*backReference)
+                        << " is set to something else.";
+                    return std::make_optional(errorText);
+                }
+            }
+        }
+        // If list of referenced instances, check that each one has a back reference to our
+        // instance on the other side
+        else
+        {
+            // for now, do not support n:m
+            if (backReference->isTransient())
+            {
+                qCritical() << "QtOrm: Many-to-many relation is not supported in related entities"
+                            << mapping << "<->" << *backReference;
+                Q_ORM_NOT_IMPLEMENTED;
+            }
+
+            QVector<QObject*> referencedInstances =
+                propertyValue(entityInstance, mapping).value<QVector<QObject*>>();
+
+            for (const QObject* referencedInstance : referencedInstances)
+            {
+                // QVector<T*> <-> T*
+                // check that the entity on the other side references this one
+                QObject* backReferencedEntity =
+                    propertyValue(referencedInstance, *backReference).value<QObject*>();
+
+                if (backReferencedEntity != entityInstance)
+                {
+                    QString errorText;
+                    QDebug dbg{&errorText};
+                    dbg.noquote().nospace()
+                        << entityInstanceRepresentation(entity, entityInstance)
+                        << " references "
+                        << entityInstanceRepresentation(*mapping.referencedEntity(),
+                                                        referencedInstance)
+                        << " but its back-reference "
+                        << shortPropertyMappingRepresentation(*backReference)
+                        << " is set to something else.";
+
+                    return std::make_optional(errorText);
+                }
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+void QOrmCrossReferenceValidator::clear()
+{
+    for (auto it = d->m_backReferences.cbegin(); it != d->m_backReferences.cend(); ++it)
+        const_cast<QObject*>(it.key())->disconnect(d.get());
+
+    d->m_backReferences.clear();
+}
+
+QT_END_NAMESPACE
+
+#include "qormcrossreferencevalidator_p.moc"
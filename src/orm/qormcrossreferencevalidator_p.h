@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMCROSSREFERENCEVALIDATOR_P_H
+#define QORMCROSSREFERENCEVALIDATOR_P_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qstring.h>
+
+#include <memory>
+#include <optional>
+
+QT_BEGIN_NAMESPACE
+
+class QObject;
+class QOrmMetadata;
+class QOrmCrossReferenceValidatorPrivate;
+
+// Checks that the references of an entity instance and their back-references point to each
+// other. The instances listed in one-to-many back-references are memoized until the instance
+// holding the list notifies a change of it, so that validating the N children of an instance
+// reads the list once instead of N times.
+class Q_ORM_EXPORT QOrmCrossReferenceValidator
+{
+    Q_DISABLE_COPY(QOrmCrossReferenceValidator)
+
+public:
+    QOrmCrossReferenceValidator();
+    ~QOrmCrossReferenceValidator();
+
+    // Returns the description of the first inconsistency found
+    Q_REQUIRED_RESULT
+    std::optional<QString> validate(const QOrmMetadata& entity, const QObject* entityInstance);
+
+    void clear();
+
+private:
+    std::unique_ptr<QOrmCrossReferenceValidatorPrivate> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMCROSSREFERENCEVALIDATOR_P_H
@@ -27,6 +27,8 @@
 #include <QSet>
 #include <QVariant>
 
+#include <unordered_map>
+
 QT_BEGIN_NAMESPACE
 
 class QOrmEntityInstanceCachePrivate : public QObject
@@ -36,13 +38,23 @@ class QOrmEntityInstanceCachePrivate : public QObject
     friend class QOrmEntityInstanceCache;
     using ObjectId = QPair<QString, QVariant>;
 
+    struct PersistedState
+    {
+        QOrmMetadata entity;
+        QVector<QVariant> values;
+    };
+
 private slots:
     void onEntityInstanceChanged();
 
 private:
     QHash<QObject*, ObjectId> m_cache;
     QMap<ObjectId, QObject*> m_byObjectId;
-    QSet<const QObject*> m_modifiedInstances;    
+    QHash<QString, QSet<QObject*>> m_byClassName;
+    QSet<QString> m_fullyLoadedClassNames;
+    QSet<const QObject*> m_modifiedInstances;
+    // property values as they were last read from or written to the backend
+    std::unordered_map<const QObject*, PersistedState> m_persistedStates;
 };
 
 void QOrmEntityInstanceCachePrivate::onEntityInstanceChanged()
@@ -90,17 +102,48 @@ void QOrmEntityInstanceCache::insert(const QOrmMetadata& metadata, QObject* inst
 
     d->m_cache.insert(instance, objectId);
     d->m_byObjectId.insert(objectId, instance);
+    d->m_byClassName[objectId.first].insert(instance);
 }
 
 QObject* QOrmEntityInstanceCache::take(QObject* instance)
 {
-    d->m_byObjectId.remove(d->m_cache[instance]);
+    auto it = d->m_cache.find(instance);
+
+    if (it == std::end(d->m_cache))
+        return instance;
+
+    instance->disconnect(d.get());
+
+    d->m_byObjectId.remove(it.value());
+    d->m_byClassName[it.value().first].remove(instance);
     d->m_modifiedInstances.remove(instance);
-    d->m_cache.remove(instance);
+    d->m_persistedStates.erase(instance);
+    d->m_cache.erase(it);
 
     return instance;
 }
 
+QVector<QObject*> QOrmEntityInstanceCache::takeAll()
+{
+    QVector<QObject*> instances;
+    instances.reserve(d->m_cache.size());
+
+    for (auto it = std::begin(d->m_cache); it != std::end(d->m_cache); ++it)
+    {
+        it.key()->disconnect(d.get());
+        instances.push_back(it.key());
+    }
+
+    d->m_cache.clear();
+    d->m_byObjectId.clear();
+    d->m_byClassName.clear();
+    d->m_fullyLoadedClassNames.clear();
+    d->m_modifiedInstances.clear();
+    d->m_persistedStates.clear();
+
+    return instances;
+}
+
 void QOrmEntityInstanceCache::finalize(const QOrmMetadata& metadata, QObject* instance)
 {
     for (const QOrmPropertyMapping& mapping : metadata.propertyMappings())
@@ -116,6 +159,12 @@ void QOrmEntityInstanceCache::finalize(const QOrmMetadata& metadata, QObject* in
 
         QObject::connect(instance, notifySignal, d.get(), slot);
     }
+
+    d->m_persistedStates.insert_or_assign(
+        instance,
+        QOrmEntityInstanceCachePrivate::PersistedState{
+            metadata,
+            QOrmPrivate::entityInstanceSnapshot(metadata, instance)});
 }
 
 bool QOrmEntityInstanceCache::isModified(const QObject* instance) const
@@ -126,6 +175,47 @@ bool QOrmEntityInstanceCache::isModified(const QObject* instance) const
 void QOrmEntityInstanceCache::markUnmodified(const QObject* instance) const
 {
     d->m_modifiedInstances.remove(instance);
+
+    auto it = d->m_persistedStates.find(instance);
+
+    if (it != std::end(d->m_persistedStates))
+        it->second.values = QOrmPrivate::entityInstanceSnapshot(it->second.entity, instance);
+}
+
+QVector<QVariant> QOrmEntityInstanceCache::snapshot(const QObject* instance) const
+{
+    auto it = d->m_persistedStates.find(instance);
+
+    return it == std::end(d->m_persistedStates) ? QVector<QVariant>{} : it->second.values;
+}
+
+QVector<QObject*> QOrmEntityInstanceCache::instances(const QOrmMetadata& meta) const
+{
+    QVector<QObject*> result;
+    auto it = d->m_byClassName.constFind(meta.className());
+
+    if (it == d->m_byClassName.cend())
+        return result;
+
+    result.reserve(it.value().size());
+
+    for (QObject* instance : it.value())
+        result.push_back(instance);
+
+    return result;
+}
+
+bool QOrmEntityInstanceCache::isFullyLoaded(const QOrmMetadata& meta) const
+{
+    return d->m_fullyLoadedClassNames.contains(meta.className());
+}
+
+void QOrmEntityInstanceCache::setFullyLoaded(const QOrmMetadata& meta, bool isFullyLoaded)
+{
+    if (isFullyLoaded)
+        d->m_fullyLoadedClassNames.insert(meta.className());
+    else
+        d->m_fullyLoadedClassNames.remove(meta.className());
 }
 
 QT_END_NAMESPACE
@@ -23,6 +23,8 @@
 
 #include <QtCore/qglobal.h>
 #include <QtCore/qscopedpointer.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 #include <QtOrm/qormglobal.h>
 
 QT_BEGIN_NAMESPACE
@@ -42,11 +44,25 @@ public:
     bool contains(const QObject* instance) const;
     void insert(const QOrmMetadata& meta, QObject* instance);
     QObject* take(QObject* instance);
+    // Removes all entity instances from the cache and returns them without deleting them
+    Q_REQUIRED_RESULT
+    QVector<QObject*> takeAll();
 
     void finalize(const QOrmMetadata& metadata, QObject* instance);
     bool isModified(const QObject* instance) const;
     void markUnmodified(const QObject* instance) const;
 
+    Q_REQUIRED_RESULT
+    QVector<QVariant> snapshot(const QObject* instance) const;
+
+    Q_REQUIRED_RESULT
+    QVector<QObject*> instances(const QOrmMetadata& meta) const;
+
+    // A fully loaded entity has all of its rows in the cache: queries can be evaluated in memory
+    Q_REQUIRED_RESULT
+    bool isFullyLoaded(const QOrmMetadata& meta) const;
+    void setFullyLoaded(const QOrmMetadata& meta, bool isFullyLoaded);
+
 private:
     QScopedPointer<QOrmEntityInstanceCachePrivate> d;
 };
@@ -57,4 +57,145 @@ void QOrmEntityListModelBase::setOrder(QVariantList order)
     }
 }
 
+int QOrmEntityListModelBase::pageSize() const
+{
+    return m_pageSize;
+}
+
+void QOrmEntityListModelBase::setPageSize(int pageSize)
+{
+    Q_ASSERT(pageSize >= 0);
+
+    if (m_pageSize != pageSize)
+    {
+        m_pageSize = pageSize;
+        Q_EMIT pageSizeChanged();
+        read();
+    }
+}
+
+int QOrmEntityListModelBase::prefetchWindow() const
+{
+    return m_prefetchWindow;
+}
+
+void QOrmEntityListModelBase::setPrefetchWindow(int prefetchWindow)
+{
+    Q_ASSERT(prefetchWindow >= 0);
+
+    if (m_prefetchWindow != prefetchWindow)
+    {
+        m_prefetchWindow = prefetchWindow;
+        Q_EMIT prefetchWindowChanged();
+    }
+}
+
+// Called from data(): the rows cannot be inserted while the view is reading them, so the next
+// page is fetched from the event loop.
+void QOrmEntityListModelBase::prefetch(int row) const
+{
+    if (m_prefetchWindow <= 0 || m_isPrefetchScheduled || row < rowCount() - m_prefetchWindow)
+        return;
+
+    auto* self = const_cast<QOrmEntityListModelBase*>(this);
+    m_isPrefetchScheduled = true;
+
+    QMetaObject::invokeMethod(
+        self,
+        [self]() {
+            self->m_isPrefetchScheduled = false;
+
+            if (self->canFetchMore(QModelIndex{}))
+                self->fetchMore(QModelIndex{});
+        },
+        Qt::QueuedConnection);
+}
+
+QVariant QOrmEntityListModelBase::collectionValue(QObject* entityInstance,
+                                                  int role,
+                                                  const QMetaProperty& property) const
+{
+    QHash<int, QVariant>& cachedValues = m_collectionValues[entityInstance];
+    auto it = cachedValues.find(role);
+
+    if (it != std::end(cachedValues))
+        return it.value();
+
+    QVariantList list;
+
+    for (QObject* o : property.read(entityInstance).value<QVector<QObject*>>())
+        list.push_back(QVariant::fromValue(o));
+
+    // Without a NOTIFY signal there is no way to tell when the cached value gets stale
+    if (!property.hasNotifySignal())
+        return list;
+
+    static const QMetaMethod onPropertyChanged = staticMetaObject.method(
+        staticMetaObject.indexOfSlot("onEntityInstancePropertyChanged()"));
+
+    connect(entityInstance,
+            property.notifySignal(),
+            this,
+            onPropertyChanged,
+            Qt::UniqueConnection);
+    // the cached values are keyed by the instance, which must not outlive them
+    connect(entityInstance,
+            &QObject::destroyed,
+            this,
+            &QOrmEntityListModelBase::onEntityInstanceDestroyed,
+            Qt::UniqueConnection);
+
+    if (!m_collectionRolesByNotifySignal.contains(property.notifySignalIndex(), role))
+        m_collectionRolesByNotifySignal.insert(property.notifySignalIndex(), role);
+
+    cachedValues.insert(role, list);
+
+    return list;
+}
+
+void QOrmEntityListModelBase::forgetEntityInstance(const QObject* entityInstance)
+{
+    if (m_collectionValues.remove(entityInstance) > 0)
+        disconnect(entityInstance, nullptr, this, nullptr);
+}
+
+void QOrmEntityListModelBase::forgetEntityInstances()
+{
+    for (auto it = std::cbegin(m_collectionValues); it != std::cend(m_collectionValues); ++it)
+        disconnect(it.key(), nullptr, this, nullptr);
+
+    m_collectionValues.clear();
+}
+
+void QOrmEntityListModelBase::onEntityInstancePropertyChanged()
+{
+    QObject* entityInstance = sender();
+    auto it = m_collectionValues.find(entityInstance);
+
+    if (it == std::end(m_collectionValues))
+        return;
+
+    QVector<int> changedRoles;
+
+    for (int role : m_collectionRolesByNotifySignal.values(senderSignalIndex()))
+    {
+        if (it.value().remove(role) > 0)
+            changedRoles.push_back(role);
+    }
+
+    if (it.value().isEmpty())
+        forgetEntityInstance(entityInstance);
+
+    int row = indexOf(entityInstance);
+
+    if (row >= 0 && !changedRoles.isEmpty())
+        Q_EMIT dataChanged(index(row), index(row), changedRoles);
+}
+
+// The connections of a destroyed instance are gone already: only its cached values are dropped
+void QOrmEntityListModelBase::onEntityInstanceDestroyed(QObject* entityInstance)
+{
+    m_collectionValues.remove(entityInstance);
+}
+
 QT_END_NAMESPACE
@@ -24,6 +24,7 @@
 #include <QtCore/qabstractitemmodel.h>
 #include <QtCore/qbytearray.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qmetaobject.h>
 #include <QtCore/qvariant.h>
 #include <QtCore/qvector.h>
 
@@ -34,9 +35,12 @@
 #include <QtOrm/qormorder.h>
 #include <QtOrm/qormqueryresult.h>
 #include <QtOrm/qormsession.h>
+#include <QtOrm/qormtracer.h>
 
 #include <QDebug>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 class Q_ORM_EXPORT QOrmEntityListModelBase : public QAbstractListModel
@@ -45,6 +49,9 @@ class Q_ORM_EXPORT QOrmEntityListModelBase : public QAbstractListModel
 
     Q_PROPERTY(QVariantMap filter READ filter WRITE setFilter NOTIFY filterChanged)
     Q_PROPERTY(QVariantList order READ order WRITE setOrder NOTIFY orderChanged)
+    Q_PROPERTY(int pageSize READ pageSize WRITE setPageSize NOTIFY pageSizeChanged)
+    Q_PROPERTY(
+        int prefetchWindow READ prefetchWindow WRITE setPrefetchWindow NOTIFY prefetchWindowChanged)
 
 public:
     QOrmEntityListModelBase(QObject* parent = nullptr);
@@ -55,6 +62,12 @@ public:
     QVariantList order() const;
     void setOrder(QVariantList order);
 
+    int pageSize() const;
+    void setPageSize(int pageSize);
+
+    int prefetchWindow() const;
+    void setPrefetchWindow(int prefetchWindow);
+
 public Q_SLOTS:
     virtual QObject* at(int index) const = 0;
     virtual int indexOf(QObject* entityInstance) const = 0;
@@ -68,16 +81,34 @@ Q_SIGNALS:
     void entityInstanceCreated();
     void entityInstanceRemoved();
     void filterChanged();
-    void orderChanged();    
+    void orderChanged();
+    void pageSizeChanged();
+    void prefetchWindowChanged();
 
 protected Q_SLOTS:
     virtual void onFilterChanged() = 0;
     virtual void onOrderChanged() = 0;
     virtual void readData() = 0;
+    void onEntityInstancePropertyChanged();
+    void onEntityInstanceDestroyed(QObject* entityInstance);
+
+protected:
+    void prefetch(int row) const;
+    QVariant collectionValue(QObject* entityInstance, int role, const QMetaProperty& property) const;
+    void forgetEntityInstance(const QObject* entityInstance);
+    void forgetEntityInstances();
 
 protected:
     QVariantMap m_filter;
     QVariantList m_order;
+    int m_pageSize{0};
+    int m_prefetchWindow{0};
+
+private:
+    mutable bool m_isPrefetchScheduled{false};
+    // QVector<T*> properties converted to QVariantList, until the NOTIFY signal of the property
+    mutable QHash<const QObject*, QHash<int, QVariant>> m_collectionValues;
+    mutable QMultiHash<int, int> m_collectionRolesByNotifySignal;
 };
 
 template<typename T>
@@ -88,14 +119,15 @@ public:
         : QOrmEntityListModelBase{parent}
         , m_session{session}
     {
-        readData();
-
         int roleIndex = Qt::UserRole;
 
         for (const QOrmPropertyMapping& propertyMapping :
              m_session.metadataCache()->get<T>().propertyMappings())
         {
-            m_roles.insert(std::make_pair(roleIndex, propertyMapping));
+            bool isCollection = propertyMapping.dataTypeName().startsWith("QVector<") &&
+                                propertyMapping.dataTypeName().endsWith("*>");
+
+            m_roleAccessors.push_back(RoleAccessor{propertyMapping.qMetaProperty(), isCollection});
             m_roleNames.insert(roleIndex, propertyMapping.classPropertyName().toUtf8());
             roleIndex++;
         }
@@ -103,24 +135,20 @@ public:
 
     QObject* at(int index) const override
     {
+        ensureDataRead();
         return index >= 0 && index < m_data.size() ? m_data[index] : nullptr;
     }
 
     int indexOf(QObject* instance) const override
     {
-        for (int i = 0; i < m_data.size(); ++i)
-        {
-            if (static_cast<void*>(m_data[i]) == static_cast<void*>(instance))
-            {
-                return i;
-            }
-        }
-
-        return -1;
+        ensureDataRead();
+        return m_rows.value(instance, -1);
     }
 
     QObject* create(QVariantMap properties) override
     {
+        ensureDataRead();
+
         T* instance = new T{};
 
         for (auto it = std::cbegin(properties); it != std::cend(properties); ++it)
@@ -136,8 +164,7 @@ public:
             // Update back reference if any
             if (propertyMapping->isReference() && !propertyMapping->isTransient())
             {
-                const QOrmPropertyMapping* backReference =
-                    QOrmPrivate::backReference(*propertyMapping);
+                const QOrmPropertyMapping* backReference = propertyMapping->backReference();
 
                 Q_ASSERT(backReference != nullptr);
 
@@ -163,7 +190,18 @@ public:
         if (m_session.merge(instance))
         {
             Q_EMIT entityInstanceCreated();
-            read();
+
+            int row = matchesFilter(instance) ? insertionRow(instance) : -1;
+
+            // Rows after the last fetched one arrive with the next page
+            if (row >= 0 && (row < m_data.size() || !m_hasMoreRows))
+            {
+                beginInsertRows(QModelIndex{}, row, row);
+                m_data.insert(row, instance);
+                reindexRows(row);
+                endInsertRows();
+            }
+
             return instance;
         }
 
@@ -182,8 +220,7 @@ public:
             {
                 QObject* referencedInstance =
                     QOrmPrivate::propertyValue(entityInstance, propertyMapping).value<QObject*>();
-                const QOrmPropertyMapping* backReference =
-                    QOrmPrivate::backReference(propertyMapping);
+                const QOrmPropertyMapping* backReference = propertyMapping.backReference();
 
                 Q_ASSERT(backReference != nullptr);
 
@@ -205,97 +242,179 @@ public:
             }
         }
 
+        // The session might delete the instance: find its row and forget it beforehand, only the
+        // row itself is removed afterwards
+        int row = indexOf(entityInstance);
+
+        if (row >= 0)
+        {
+            forgetEntityInstance(entityInstance);
+            m_rows.remove(entityInstance);
+        }
+
         if (m_session.remove(qobject_cast<T*>(entityInstance)))
         {
             Q_EMIT entityInstanceRemoved();
-            read();
+
+            if (row >= 0)
+            {
+                beginRemoveRows(QModelIndex{}, row, row);
+                m_data.remove(row);
+                reindexRows(row);
+                endRemoveRows();
+            }
+
             return true;
         }
 
+        if (row >= 0)
+            m_rows.insert(entityInstance, row);
+
         return false;
     }
 
     bool removeAt(int index) override
     {
-        if (index >= 0 && index <= m_data.size() && m_session.remove(m_data[index]))
+        ensureDataRead();
+        return index >= 0 && index < m_data.size() && remove(m_data[index]);
+    }
+
+    bool update(QObject* entityInstance) override
+    {
+        if (!m_session.merge(entityInstance))
+            return false;
+
+        T* instance = qobject_cast<T*>(entityInstance);
+        int row = indexOf(entityInstance);
+
+        if (row < 0)
+            return true;
+
+        // keep the row where the current order puts it
+        m_data.remove(row);
+        int newRow = matchesFilter(instance) ? insertionRow(instance) : -1;
+        m_data.insert(row, instance);
+
+        // A row moving past the last fetched one would also move the position of the next page
+        if (newRow < 0 || (newRow == m_data.size() - 1 && m_hasMoreRows))
         {
-            read();
+            beginRemoveRows(QModelIndex{}, row, row);
+            removeRow(row);
+            endRemoveRows();
+
             return true;
         }
-        return false;
-    }
 
-    bool update(QObject* instance) override { return m_session.merge(instance); }
+        if (newRow != row)
+        {
+            beginMoveRows(QModelIndex{}, row, row, QModelIndex{}, newRow > row ? newRow + 1 : newRow);
+            m_data.move(row, newRow);
+            reindexRows(qMin(row, newRow));
+            endMoveRows();
+        }
+
+        Q_EMIT dataChanged(index(newRow), index(newRow));
+
+        return true;
+    }
 
     void read() override
     {
+        // nothing to reload yet: the first access reads the rows with the current settings
+        if (!m_isDataRead)
+            return;
+
+        Q_ORM_TRACE_SCOPE_DETAIL("model",
+                                 "reload",
+                                 QString::fromUtf8(T::staticMetaObject.className()));
+
         Q_EMIT beginResetModel();
         readData();
         Q_EMIT endResetModel();
     }
 
-    int rowCount(const QModelIndex& = QModelIndex{}) const { return m_data.size(); }
+    int rowCount(const QModelIndex& = QModelIndex{}) const
+    {
+        ensureDataRead();
+        return m_data.size();
+    }
+
+    bool canFetchMore(const QModelIndex& parent) const override
+    {
+        ensureDataRead();
+        return !parent.isValid() && m_hasMoreRows;
+    }
+
+    void fetchMore(const QModelIndex& parent) override
+    {
+        if (!canFetchMore(parent))
+            return;
+
+        Q_ORM_TRACE_SCOPE_DETAIL("model",
+                                 "fetchMore",
+                                 QString::fromUtf8(T::staticMetaObject.className()));
+
+        QVector<T*> page = selectPage();
+        m_hasMoreRows = page.size() >= m_pageSize;
+
+        if (page.isEmpty())
+            return;
+
+        int firstRow = m_data.size();
+
+        beginInsertRows(QModelIndex{}, firstRow, firstRow + page.size() - 1);
+        m_data += page;
+        reindexRows(firstRow);
+        endInsertRows();
+    }
 
     QHash<int, QByteArray> roleNames() const { return m_roleNames; }
 
     QVariant data(const QModelIndex& index, int role) const
     {
-        if (index.row() >= 0 && index.row() < m_data.size())
-        {
-            const QOrmPropertyMapping& propertyMapping = m_roles.at(role);
-
-            QVariant propertyValue =
-                m_data[index.row()]->property(propertyMapping.classPropertyName().toUtf8().data());
+        ensureDataRead();
 
-            if (propertyValue.type() == QVariant::UserType &&
-                QString{propertyValue.typeName()}.startsWith("QVector<") &&
-                QString{propertyValue.typeName()}.endsWith("*>"))
-            {
-                QVariantList list;
+        int roleIndex = role - Qt::UserRole;
 
-                for (const QObject* o : propertyValue.value<QVector<QObject*>>())
-                {
-                    list.push_back(o);
-                }
+        if (index.row() >= 0 && index.row() < m_data.size() && roleIndex >= 0 &&
+            roleIndex < m_roleAccessors.size())
+        {
+            prefetch(index.row());
 
-                propertyValue = list;
-            }
+            const RoleAccessor& accessor = m_roleAccessors[roleIndex];
 
-            return propertyValue;
+            return accessor.isCollection
+                       ? collectionValue(m_data[index.row()], role, accessor.property)
+                       : accessor.property.read(m_data[index.row()]);
         }
         return {};
     }
 
 private:
-    void onFilterChanged() override { readData(); }
+    // The filter or the order changes the set of rows completely: re-query
+    void onFilterChanged() override { read(); }
 
-    void onOrderChanged() override { readData(); }
+    void onOrderChanged() override { read(); }
 
     void readData() override
     {
-        std::optional<QOrmFilterExpression> filterExpression;
-        std::vector<QOrmOrder> order;
+        m_filterExpression.reset();
 
         for (auto it = std::begin(m_filter); it != std::end(m_filter); ++it)
         {
             auto predicate = QOrmClassProperty{it.key().toUtf8().data()} == it.value();
 
-            if (filterExpression.has_value())
+            if (m_filterExpression.has_value())
             {
-                filterExpression = *filterExpression && predicate;
+                m_filterExpression = *m_filterExpression && predicate;
             }
             else
             {
-                filterExpression = predicate;
+                m_filterExpression = predicate;
             }
         }
 
-        auto query = m_session.from<T>();
-
-        if (filterExpression.has_value())
-        {
-            query.filter(*filterExpression);
-        }
+        m_resolvedOrder.clear();
 
         for (const QVariant& orderItem : m_order)
         {
@@ -304,15 +423,11 @@ private:
                 QVariantMap orderItemMap = orderItem.toMap();
 
                 for (auto it = std::cbegin(orderItemMap); it != std::cend(orderItemMap); ++it)
-                {
-                    query.order(QOrmClassProperty{it.key().toUtf8().data()},
-                                it.value().value<Qt::SortOrder>());
-                }
+                    addOrder(it.key(), it.value().value<Qt::SortOrder>());
             }
             else if (orderItem.type() == QVariant::String)
             {
-                query.order(QOrmClassProperty{orderItem.toString().toUtf8().data()},
-                            Qt::AscendingOrder);
+                addOrder(orderItem.toString(), Qt::AscendingOrder);
             }
             else
             {
@@ -320,14 +435,213 @@ private:
             }
         }
 
-        m_data = query.select().toVector();
+        // Pages are positioned after the last fetched row, so the order must be total
+        const QOrmPropertyMapping* objectIdMapping =
+            m_session.metadataCache()->get<T>().objectIdMapping();
+
+        if (m_pageSize > 0 && objectIdMapping != nullptr &&
+            std::none_of(std::cbegin(m_resolvedOrder),
+                         std::cend(m_resolvedOrder),
+                         [objectIdMapping](const QOrmOrder& order) {
+                             return order.mapping().isObjectId();
+                         }))
+        {
+            m_resolvedOrder.emplace_back(*objectIdMapping, Qt::AscendingOrder);
+        }
+
+        forgetEntityInstances();
+        m_data.clear();
+        m_data = selectPage();
+        m_hasMoreRows = m_pageSize > 0 && m_data.size() >= m_pageSize;
+
+        m_rows.clear();
+        reindexRows(0);
+
+        m_isDataRead = true;
+    }
+
+    // The rows are read on first access rather than on construction, so that the filter, the
+    // order and the page size set afterwards apply to the first read
+    void ensureDataRead() const
+    {
+        if (!m_isDataRead)
+            const_cast<QOrmEntityListModel*>(this)->readData();
+    }
+
+    void reindexRows(int firstRow)
+    {
+        for (int i = firstRow; i < m_data.size(); ++i)
+            m_rows.insert(m_data[i], i);
+    }
+
+    void removeRow(int row)
+    {
+        forgetEntityInstance(m_data[row]);
+        m_rows.remove(m_data[row]);
+        m_data.remove(row);
+        reindexRows(row);
+    }
+
+    void addOrder(const QString& propertyName, Qt::SortOrder direction)
+    {
+        const QOrmPropertyMapping* propertyMapping =
+            m_session.metadataCache()->get<T>().classPropertyMapping(propertyName);
+        Q_ASSERT(propertyMapping != nullptr);
+
+        m_resolvedOrder.emplace_back(*propertyMapping, direction);
+    }
+
+    // Selects the rows following the fetched ones; all of them if the model is not paged
+    QVector<T*> selectPage()
+    {
+        auto query = m_session.from<T>();
+        std::optional<QOrmFilterExpression> filterExpression = m_filterExpression;
+
+        if (m_pageSize > 0 && !m_data.isEmpty())
+        {
+            std::optional<QOrmFilterExpression> keyset = keysetPredicate(m_data.last());
+
+            if (keyset.has_value())
+            {
+                filterExpression = filterExpression.has_value() ? *filterExpression && *keyset
+                                                                : *keyset;
+            }
+            else
+            {
+                query.offset(m_data.size());
+            }
+        }
+
+        if (filterExpression.has_value())
+            query.filter(*filterExpression);
+
+        for (const QOrmOrder& order : m_resolvedOrder)
+        {
+            query.order(QOrmClassProperty{order.mapping().classPropertyName().toUtf8().data()},
+                        order.direction());
+        }
+
+        if (m_pageSize > 0)
+            query.limit(m_pageSize);
+
+        return query.select().toVector();
+    }
+
+    // (k1 > v1) OR (k1 = v1 AND k2 > v2) OR ... for the order keys of the last fetched row.
+    // NULLs do not compare in SQL: the page is positioned with OFFSET then. As SQLite sorts NULLs
+    // first, they follow the last fetched row in descending order, where k < v would skip them:
+    // descending keys other than the object ID, which cannot be NULL, are paged with OFFSET too.
+    std::optional<QOrmFilterExpression> keysetPredicate(const T* lastInstance) const
+    {
+        if (m_resolvedOrder.empty() || !m_resolvedOrder.back().mapping().isObjectId())
+            return std::nullopt;
+
+        std::optional<QOrmFilterExpression> keyset;
+        std::optional<QOrmFilterExpression> equalKeys;
+
+        for (const QOrmOrder& order : m_resolvedOrder)
+        {
+            const QOrmPropertyMapping& mapping = order.mapping();
+
+            if (order.direction() == Qt::DescendingOrder && !mapping.isObjectId())
+                return std::nullopt;
+
+            QVariant value = mapping.qMetaProperty().read(lastInstance);
+
+            bool isNull = mapping.isReference() && !mapping.isTransient()
+                              ? value.value<QObject*>() == nullptr
+                              : value.isNull();
+
+            if (isNull)
+                return std::nullopt;
+
+            QOrmFilterExpression next = order.direction() == Qt::AscendingOrder
+                                            ? QOrmFilterExpression{mapping > value}
+                                            : QOrmFilterExpression{mapping < value};
+
+            if (equalKeys.has_value())
+                next = *equalKeys && next;
+
+            keyset = keyset.has_value() ? *keyset || next : next;
+            equalKeys = equalKeys.has_value() ? *equalKeys && (mapping == value)
+                                              : QOrmFilterExpression{mapping == value};
+        }
+
+        return keyset;
+    }
+
+    bool matchesFilter(const T* instance) const
+    {
+        for (auto it = std::cbegin(m_filter); it != std::cend(m_filter); ++it)
+        {
+            const QOrmPropertyMapping* propertyMapping =
+                m_session.metadataCache()->get<T>().classPropertyMapping(it.key());
+            Q_ASSERT(propertyMapping != nullptr);
+
+            QVariant filterValue = it.value();
+
+            if (propertyMapping->isReference() && !propertyMapping->isTransient())
+            {
+                const QObject* referencedInstance = filterValue.value<QObject*>();
+                filterValue = referencedInstance == nullptr
+                                  ? filterValue
+                                  : QOrmPrivate::objectIdPropertyValue(
+                                        referencedInstance, *propertyMapping->referencedEntity());
+            }
+
+            QVariant value = QOrmPrivate::comparablePropertyValue(instance, *propertyMapping);
+
+            if (QOrmPrivate::compareValues(value, filterValue) != 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool lessThan(const T* lhs, const T* rhs) const
+    {
+        for (const QOrmOrder& order : m_resolvedOrder)
+        {
+            int result =
+                QOrmPrivate::compareValues(QOrmPrivate::comparablePropertyValue(lhs, order.mapping()),
+                                           QOrmPrivate::comparablePropertyValue(rhs, order.mapping()));
+
+            if (result != 0)
+                return order.direction() == Qt::AscendingOrder ? result < 0 : result > 0;
+        }
+
+        return false;
+    }
+
+    // Rows without an explicit order come in the insertion order, i.e. new rows go last
+    int insertionRow(const T* instance) const
+    {
+        auto it = std::upper_bound(std::cbegin(m_data),
+                                   std::cend(m_data),
+                                   instance,
+                                   [this](const T* lhs, const T* rhs) { return lessThan(lhs, rhs); });
+
+        return static_cast<int>(std::distance(std::cbegin(m_data), it));
     }
 
 private:
+    struct RoleAccessor
+    {
+        QMetaProperty property;
+        bool isCollection;
+    };
+
     QOrmSession& m_session;
     QVector<T*> m_data;
+    QHash<const QObject*, int> m_rows;
     QHash<int, QByteArray> m_roleNames;
-    std::unordered_map<int, QOrmPropertyMapping> m_roles;
+    QVector<RoleAccessor> m_roleAccessors;
+    std::vector<QOrmOrder> m_resolvedOrder;
+    std::optional<QOrmFilterExpression> m_filterExpression;
+    bool m_hasMoreRows{false};
+    bool m_isDataRead{false};
 };
 
 QT_END_NAMESPACE
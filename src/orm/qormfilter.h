@@ -24,6 +24,7 @@
 #include <QtOrm/qormglobal.h>
 #include <QtOrm/qormfilterexpression.h>
 
+#include <functional>
 #include <variant>
 
 QT_BEGIN_NAMESPACE
@@ -37,6 +38,12 @@ public:
     {
     }
 
+    explicit QOrmFilter(std::function<bool(const QObject*)> invokable)
+        : m_type{QOrm::FilterType::Invokable}
+        , m_filter{std::move(invokable)}
+    {
+    }
+
     Q_REQUIRED_RESULT
     QOrm::FilterType type() const
     {
@@ -49,9 +56,15 @@ public:
         return std::get_if<QOrmFilterExpression>(&m_filter);
     }
 
+    Q_REQUIRED_RESULT
+    const std::function<bool(const QObject*)>* invokable() const
+    {
+        return std::get_if<std::function<bool(const QObject*)>>(&m_filter);
+    }
+
 private:
     QOrm::FilterType m_type;
-    std::variant<QOrmFilterExpression, void*> m_filter{nullptr};
+    std::variant<QOrmFilterExpression, std::function<bool(const QObject*)>> m_filter;
 };
 
 extern Q_ORM_EXPORT QDebug operator<<(QDebug debug, const QOrmFilter& filter);
@@ -31,6 +31,7 @@ QT_BEGIN_NAMESPACE
  * Expr = [ '(' ] ( TerminalPredicate | BinaryPredicate | UnaryPredicate ) [ ')' ] ;
  * BinaryPredicate = Expr OP Expr
  * UnaryPredicate = '!' Expr
+ * NaryPredicate = Expr { OP Expr } ;
  * COMP = '<' | '>' | '<=' | '>=' | '==' | '!=' ;
  * OP = '&&' | '||' ;
  *
@@ -41,7 +42,8 @@ class QOrmFilterExpressionPrivate : public QSharedData
 public:
     using Predicate = std::variant<QOrmFilterTerminalPredicate,
                                    QOrmFilterBinaryPredicate,
-                                   QOrmFilterUnaryPredicate>;
+                                   QOrmFilterUnaryPredicate,
+                                   QOrmFilterNaryPredicate>;
 
     QOrmFilterExpressionPrivate(Predicate predicate)
         : m_predicate{predicate}
@@ -66,6 +68,11 @@ QOrmFilterExpression::QOrmFilterExpression(const QOrmFilterUnaryPredicate& unary
 {
 }
 
+QOrmFilterExpression::QOrmFilterExpression(const QOrmFilterNaryPredicate& naryPredicate)
+    : d{new QOrmFilterExpressionPrivate{naryPredicate}}
+{
+}
+
 QOrmFilterExpression::QOrmFilterExpression(const QOrmFilterExpression&) = default;
 
 QOrmFilterExpression::QOrmFilterExpression(QOrmFilterExpression&&) = default;
@@ -84,6 +91,8 @@ QOrm::FilterExpressionType QOrmFilterExpression::type() const
         return QOrm::FilterExpressionType::BinaryPredicate;
     else if (std::holds_alternative<QOrmFilterUnaryPredicate>(d->m_predicate))
         return QOrm::FilterExpressionType::UnaryPredicate;
+    else if (std::holds_alternative<QOrmFilterNaryPredicate>(d->m_predicate))
+        return QOrm::FilterExpressionType::NaryPredicate;
 
     qFatal("Unexpected state of QOrmFilterExpression");
 }
@@ -91,10 +100,12 @@ QOrm::FilterExpressionType QOrmFilterExpression::type() const
 QOrmFilterTerminalPredicate::QOrmFilterTerminalPredicate(
         QOrmFilterTerminalPredicate::FilterProperty filterProperty,
         QOrm::Comparison comparison,
-        QVariant value)
+        QVariant value,
+        std::vector<QOrmPropertyMapping> path)
     : m_filterProperty{std::move(filterProperty)},
       m_comparison{comparison},
-      m_value{std::move(value)}
+      m_value{std::move(value)},
+      m_path{std::move(path)}
 {
 }
 
@@ -117,6 +128,11 @@ const QOrmPropertyMapping* QOrmFilterTerminalPredicate::propertyMapping() const
     return std::get_if<QOrmPropertyMapping>(&m_filterProperty);
 }
 
+const std::vector<QOrmPropertyMapping>& QOrmFilterTerminalPredicate::path() const
+{
+    return m_path;
+}
+
 QOrm::Comparison QOrmFilterTerminalPredicate::comparison() const
 {
     return m_comparison;
@@ -142,6 +158,11 @@ const QOrmFilterUnaryPredicate* QOrmFilterExpression::unaryPredicate() const
     return std::get_if<QOrmFilterUnaryPredicate>(&d->m_predicate);
 }
 
+const QOrmFilterNaryPredicate* QOrmFilterExpression::naryPredicate() const
+{
+    return std::get_if<QOrmFilterNaryPredicate>(&d->m_predicate);
+}
+
 /*!
  * \class QOrmFilterBinaryPredicate
  */
@@ -191,6 +212,27 @@ const QOrmFilterExpression& QOrmFilterUnaryPredicate::rhs() const
     return m_rhs;
 }
 
+/*!
+ * \class QOrmFilterNaryPredicate
+ */
+
+QOrmFilterNaryPredicate::QOrmFilterNaryPredicate(QOrm::BinaryLogicalOperator logicalOperator,
+                                                 QVector<QOrmFilterExpression> operands)
+    : m_logicalOperator{logicalOperator},
+      m_operands{std::move(operands)}
+{
+}
+
+QOrm::BinaryLogicalOperator QOrmFilterNaryPredicate::logicalOperator() const
+{
+    return m_logicalOperator;
+}
+
+const QVector<QOrmFilterExpression>& QOrmFilterNaryPredicate::operands() const
+{
+    return m_operands;
+}
+
 QDebug operator<<(QDebug dbg, const QOrmFilterExpression& expression)
 {
     QDebugStateSaver saver{dbg};
@@ -209,6 +251,10 @@ QDebug operator<<(QDebug dbg, const QOrmFilterExpression& expression)
         case QOrm::FilterExpressionType::UnaryPredicate:
             dbg << *expression.unaryPredicate();
             break;
+
+        case QOrm::FilterExpressionType::NaryPredicate:
+            dbg << *expression.naryPredicate();
+            break;
     }
 
     dbg << ")";
@@ -221,6 +267,9 @@ QDebug operator<<(QDebug dbg, const QOrmFilterTerminalPredicate& predicate)
 
     dbg << "QOrmFilterTerminalPredicate(";
 
+    for (const QOrmPropertyMapping& reference : predicate.path())
+        dbg << reference << ".";
+
     if (predicate.isResolved())
         dbg << *predicate.propertyMapping();
     else
@@ -251,6 +300,16 @@ QDebug operator<<(QDebug dbg, const QOrmFilterBinaryPredicate& predicate)
     return dbg;
 }
 
+QDebug operator<<(QDebug dbg, const QOrmFilterNaryPredicate& predicate)
+{
+    QDebugStateSaver saver{dbg};
+
+    dbg.nospace().noquote() << "QOrmFilterNaryPredicate(" << predicate.logicalOperator() << ", "
+                            << predicate.operands() << ")";
+
+    return dbg;
+}
+
 QOrmFilterUnaryPredicate operator!(const QOrmFilterExpression& rhs)
 {
     return {QOrm::UnaryLogicalOperator::Not, rhs};
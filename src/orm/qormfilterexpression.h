@@ -27,8 +27,11 @@
 
 #include <QtCore/qshareddata.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 
+#include <iterator>
 #include <variant>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
@@ -38,6 +41,7 @@ class QVariant;
 class QOrmFilterTerminalPredicate;
 class QOrmFilterBinaryPredicate;
 class QOrmFilterUnaryPredicate;
+class QOrmFilterNaryPredicate;
 
 class Q_ORM_EXPORT QOrmFilterExpression
 {
@@ -45,6 +49,7 @@ public:
     QOrmFilterExpression(const QOrmFilterTerminalPredicate& terminalPredicate);
     QOrmFilterExpression(const QOrmFilterBinaryPredicate& binaryPredicate);
     QOrmFilterExpression(const QOrmFilterUnaryPredicate& unaryPredicate);
+    QOrmFilterExpression(const QOrmFilterNaryPredicate& naryPredicate);
     QOrmFilterExpression(const QOrmFilterExpression&);
     QOrmFilterExpression(QOrmFilterExpression&&);
     ~QOrmFilterExpression();
@@ -57,6 +62,7 @@ public:
     Q_REQUIRED_RESULT const QOrmFilterTerminalPredicate* terminalPredicate() const;
     Q_REQUIRED_RESULT const QOrmFilterBinaryPredicate* binaryPredicate() const;
     Q_REQUIRED_RESULT const QOrmFilterUnaryPredicate* unaryPredicate() const;
+    Q_REQUIRED_RESULT const QOrmFilterNaryPredicate* naryPredicate() const;
 
 private:
     QSharedDataPointer<QOrmFilterExpressionPrivate> d;
@@ -69,13 +75,18 @@ public:
 
     QOrmFilterTerminalPredicate(FilterProperty filterProperty,
                                 QOrm::Comparison comparison,
-                                QVariant value);
+                                QVariant value,
+                                std::vector<QOrmPropertyMapping> path = {});
 
     Q_REQUIRED_RESULT bool isResolved() const;
 
     Q_REQUIRED_RESULT const QOrmClassProperty* classProperty() const;
     Q_REQUIRED_RESULT const QOrmPropertyMapping* propertyMapping() const;
 
+    // References leading from the filtered entity to the entity of propertyMapping() for
+    // resolved predicates on property paths like "province.name"; empty otherwise
+    Q_REQUIRED_RESULT const std::vector<QOrmPropertyMapping>& path() const;
+
     Q_REQUIRED_RESULT QOrm::Comparison comparison() const;
 
     Q_REQUIRED_RESULT QVariant value() const;
@@ -84,6 +95,7 @@ private:
     std::variant<QOrmClassProperty, QOrmPropertyMapping> m_filterProperty;
     QOrm::Comparison m_comparison;
     QVariant m_value;
+    std::vector<QOrmPropertyMapping> m_path;
 };
 
 class Q_ORM_EXPORT QOrmFilterBinaryPredicate
@@ -117,10 +129,27 @@ private:
     QOrmFilterExpression m_rhs;
 };
 
+// A conjunction or disjunction of any number of operands. Without operands, a conjunction is
+// always true and a disjunction is always false.
+class Q_ORM_EXPORT QOrmFilterNaryPredicate
+{
+public:
+    QOrmFilterNaryPredicate(QOrm::BinaryLogicalOperator logicalOperator,
+                            QVector<QOrmFilterExpression> operands);
+
+    Q_REQUIRED_RESULT QOrm::BinaryLogicalOperator logicalOperator() const;
+    Q_REQUIRED_RESULT const QVector<QOrmFilterExpression>& operands() const;
+
+private:
+    QOrm::BinaryLogicalOperator m_logicalOperator;
+    QVector<QOrmFilterExpression> m_operands;
+};
+
 extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmFilterExpression& expression);
 extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmFilterTerminalPredicate& predicate);
 extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmFilterBinaryPredicate& predicate);
 extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmFilterUnaryPredicate& predicate);
+extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmFilterNaryPredicate& predicate);
 
 namespace QtOrmPrivate
 {
@@ -150,8 +179,33 @@ namespace QtOrmPrivate
             return {property, comparison, QVariant::fromValue(std::forward<T>(value))};
         }
     };
+
+    template<typename Container>
+    [[nodiscard]] QVariantList toVariantList(const Container& values)
+    {
+        QVariantList list;
+        list.reserve(static_cast<int>(std::size(values)));
+
+        for (const auto& value : values)
+            list.push_back(QVariant::fromValue(value));
+
+        return list;
+    }
 } // namespace QtOrmPrivate
 
+template<typename Container>
+[[nodiscard]] inline QOrmFilterTerminalPredicate QOrmClassProperty::in(const Container& values) const
+{
+    return {*this, QOrm::Comparison::In, QtOrmPrivate::toVariantList(values)};
+}
+
+template<typename Container>
+[[nodiscard]] inline QOrmFilterTerminalPredicate
+QOrmClassProperty::notIn(const Container& values) const
+{
+    return {*this, QOrm::Comparison::NotIn, QtOrmPrivate::toVariantList(values)};
+}
+
 template<typename T>
 [[nodiscard]] inline QOrmFilterTerminalPredicate
 operator==(const QOrmFilterTerminalPredicate::FilterProperty& property, T&& value)
@@ -128,6 +128,10 @@ namespace QOrm
                 dbg << "BinaryPredicate";
                 break;
 
+            case FilterExpressionType::NaryPredicate:
+                dbg << "NaryPredicate";
+                break;
+
             case FilterExpressionType::UnaryPredicate:
                 dbg << "UnaryPredicate";
                 break;
@@ -167,6 +171,14 @@ namespace QOrm
             case Comparison::GreaterOrEqual:
                 dbg << "GreaterOrEqual";
                 break;
+
+            case Comparison::In:
+                dbg << "In";
+                break;
+
+            case Comparison::NotIn:
+                dbg << "NotIn";
+                break;
         }
 
         return dbg;
@@ -80,7 +80,9 @@ namespace QOrm
         Less,
         LessOrEqual,
         Greater,
-        GreaterOrEqual
+        GreaterOrEqual,
+        In,
+        NotIn
     };
     extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, QOrm::Comparison comparison);
     extern Q_ORM_EXPORT uint qHash(Comparison comparison) Q_DECL_NOTHROW;
@@ -119,7 +121,8 @@ namespace QOrm
     {
         TerminalPredicate,
         BinaryPredicate,
-        UnaryPredicate
+        UnaryPredicate,
+        NaryPredicate
     };
     extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, FilterExpressionType expressionType);
 
@@ -129,6 +132,25 @@ namespace QOrm
         ForceRemoveAll
     };
 
+    // Whether merging an entity instance checks that its references and their back-references
+    // point to each other
+    enum class CrossReferenceValidation
+    {
+        Always,
+        // only in debug builds of QtOrm
+        DebugOnly,
+        Off
+    };
+
+    // How merging an entity instance unknown to the session writes it to the backend
+    enum class MergeMode
+    {
+        // create it as a new entity instance
+        Default,
+        // create it or update the existing one with the same object ID, if the object ID is set
+        Upsert
+    };
+
     enum class RelationType
     {
         Query,
@@ -139,8 +161,20 @@ namespace QOrm
     enum class QueryFlags
     {
         None = 0x00,
-        OverwriteCachedInstances = 0x01
+        OverwriteCachedInstances = 0x01,
+        // Evaluate read queries against the cached entity instances without querying the backend
+        InMemory = 0x02,
+        // Evaluate in memory if the cache holds all instances of the entity
+        PreferCache = 0x04,
+        // Read detached entity instances that are neither cached nor tracked for changes. They
+        // are owned by the query result, see QOrmQueryResult::owner().
+        NoTracking = 0x08
     };
+
+    Q_DECL_CONSTEXPR inline QFlags<QueryFlags> operator|(QueryFlags lhs, QueryFlags rhs) noexcept
+    {
+        return QFlags<QueryFlags>{lhs} | rhs;
+    }
 }
 
 namespace QOrmPrivate
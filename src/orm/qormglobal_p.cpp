@@ -19,17 +19,111 @@
  */
 
 #include "qormglobal_p.h"
+#include "qormfilter.h"
 #include "qormfilterexpression.h"
 #include "qormglobal.h"
+#include "qormorder.h"
 #include "qormquery.h"
+#include "qormqueryparameter.h"
 #include "qormrelation.h"
 
 #include <QDebug>
+#include <QMetaProperty>
+#include <QSet>
+
+#include <algorithm>
 
 QT_BEGIN_NAMESPACE
 
 namespace QOrmPrivate
 {
+    static QOrm::BinaryLogicalOperator complement(QOrm::BinaryLogicalOperator logicalOperator)
+    {
+        return logicalOperator == QOrm::BinaryLogicalOperator::And
+                   ? QOrm::BinaryLogicalOperator::Or
+                   : QOrm::BinaryLogicalOperator::And;
+    }
+
+    static bool isConstant(const QOrmFilterExpression& expression,
+                           QOrm::BinaryLogicalOperator logicalOperator)
+    {
+        return expression.type() == QOrm::FilterExpressionType::NaryPredicate &&
+               expression.naryPredicate()->logicalOperator() == logicalOperator &&
+               expression.naryPredicate()->operands().isEmpty();
+    }
+
+    struct NaryOperands
+    {
+        QOrm::BinaryLogicalOperator logicalOperator;
+        QVector<QOrmFilterExpression> operands;
+        QSet<QString> keys;
+        bool isAbsorbed{false};
+    };
+
+    static void appendResolvedOperand(NaryOperands& nary, const QOrmFilterExpression& operand)
+    {
+        // Nested operands of the same operator have already been flattened and deduplicated
+        if (operand.type() == QOrm::FilterExpressionType::NaryPredicate &&
+            operand.naryPredicate()->logicalOperator() == nary.logicalOperator)
+        {
+            for (const QOrmFilterExpression& nestedOperand : operand.naryPredicate()->operands())
+                appendResolvedOperand(nary, nestedOperand);
+
+            return;
+        }
+
+        // An AND containing FALSE, or an OR containing TRUE
+        if (isConstant(operand, complement(nary.logicalOperator)))
+        {
+            nary.isAbsorbed = true;
+            return;
+        }
+
+        QString key = filterExpressionKey(operand);
+
+        if (!nary.keys.contains(key))
+        {
+            nary.keys.insert(key);
+            nary.operands.push_back(operand);
+        }
+    }
+
+    static void appendOperand(NaryOperands& nary,
+                              const QOrmRelation& relation,
+                              const QOrmFilterExpression& operand)
+    {
+        if (nary.isAbsorbed)
+            return;
+
+        if (operand.type() == QOrm::FilterExpressionType::BinaryPredicate &&
+            operand.binaryPredicate()->logicalOperator() == nary.logicalOperator)
+        {
+            appendOperand(nary, relation, operand.binaryPredicate()->lhs());
+            appendOperand(nary, relation, operand.binaryPredicate()->rhs());
+        }
+        else if (operand.type() == QOrm::FilterExpressionType::NaryPredicate &&
+                 operand.naryPredicate()->logicalOperator() == nary.logicalOperator)
+        {
+            for (const QOrmFilterExpression& nestedOperand : operand.naryPredicate()->operands())
+                appendOperand(nary, relation, nestedOperand);
+        }
+        else
+        {
+            appendResolvedOperand(nary, resolvedFilterExpression(relation, operand));
+        }
+    }
+
+    static QOrmFilterExpression resolvedNaryExpression(NaryOperands& nary)
+    {
+        if (nary.isAbsorbed)
+            return QOrmFilterNaryPredicate{complement(nary.logicalOperator), {}};
+
+        if (nary.operands.size() == 1)
+            return nary.operands.first();
+
+        return QOrmFilterNaryPredicate{nary.logicalOperator, std::move(nary.operands)};
+    }
+
     QOrmFilterExpression resolvedFilterExpression(const QOrmRelation& relation,
                                                   const QOrmFilterExpression& expression)
     {
@@ -42,23 +136,46 @@ namespace QOrmPrivate
                 if (predicate->isResolved())
                     return *predicate;
 
-                const QOrmPropertyMapping* propertyMapping = nullptr;
+                const QOrmMetadata* entity = nullptr;
 
                 switch (relation.type())
                 {
                     case QOrm::RelationType::Mapping:
-                        propertyMapping = relation.mapping()->classPropertyMapping(
-                            predicate->classProperty()->descriptor());
+                        entity = relation.mapping();
                         break;
 
                     case QOrm::RelationType::Query:
                         Q_ASSERT(relation.query()->projection().has_value());
 
-                        propertyMapping = relation.query()->projection()->classPropertyMapping(
-                            predicate->classProperty()->descriptor());
+                        entity = &*relation.query()->projection();
                         break;
                 }
 
+                // A property path like "province.name" follows references that are stored in
+                // the table of the referencing entity, i.e. the ones that can be joined
+                const QStringList segments =
+                    predicate->classProperty()->descriptor().split(QLatin1Char('.'));
+                std::vector<QOrmPropertyMapping> path;
+                const QOrmPropertyMapping* propertyMapping = nullptr;
+
+                for (int i = 0; i < segments.size(); ++i)
+                {
+                    propertyMapping = entity->classPropertyMapping(segments[i]);
+
+                    if (propertyMapping == nullptr || i == segments.size() - 1)
+                        break;
+
+                    if (!propertyMapping->isReference() || propertyMapping->isTransient())
+                    {
+                        propertyMapping = nullptr;
+                        break;
+                    }
+
+                    path.push_back(*propertyMapping);
+                    entity = propertyMapping->referencedEntity();
+                    Q_ASSERT(entity != nullptr);
+                }
+
                 if (propertyMapping == nullptr)
                 {
                     qCritical() << "QtOrm: Unable to resolve filter expression for class property"
@@ -69,31 +186,536 @@ namespace QOrmPrivate
 
                 return QOrmFilterTerminalPredicate{*propertyMapping,
                                                    predicate->comparison(),
-                                                   predicate->value()};
+                                                   predicate->value(),
+                                                   std::move(path)};
             }
 
+            // Binary and n-ary predicates are resolved to flat n-ary predicates without duplicate
+            // operands and constants
             case QOrm::FilterExpressionType::BinaryPredicate:
             {
-                const QOrmFilterBinaryPredicate* predicate = expression.binaryPredicate();
-                return QOrmFilterBinaryPredicate{resolvedFilterExpression(relation,
-                                                                          predicate->lhs()),
-                                                 predicate->logicalOperator(),
-                                                 resolvedFilterExpression(relation,
-                                                                          predicate->rhs())};
+                NaryOperands nary{expression.binaryPredicate()->logicalOperator(), {}, {}};
+                appendOperand(nary, relation, expression);
+                return resolvedNaryExpression(nary);
+            }
+
+            case QOrm::FilterExpressionType::NaryPredicate:
+            {
+                NaryOperands nary{expression.naryPredicate()->logicalOperator(), {}, {}};
+                appendOperand(nary, relation, expression);
+                return resolvedNaryExpression(nary);
             }
 
             case QOrm::FilterExpressionType::UnaryPredicate:
             {
                 const QOrmFilterUnaryPredicate* predicate = expression.unaryPredicate();
-                return QOrmFilterUnaryPredicate{predicate->logicalOperator(),
-                                                resolvedFilterExpression(relation,
-                                                                         predicate->rhs())};
+                QOrmFilterExpression rhs = resolvedFilterExpression(relation, predicate->rhs());
+
+                // NOT TRUE is FALSE, NOT FALSE is TRUE
+                if (rhs.type() == QOrm::FilterExpressionType::NaryPredicate &&
+                    rhs.naryPredicate()->operands().isEmpty())
+                {
+                    return QOrmFilterNaryPredicate{
+                        complement(rhs.naryPredicate()->logicalOperator()), {}};
+                }
+
+                if (rhs.type() == QOrm::FilterExpressionType::UnaryPredicate)
+                    return rhs.unaryPredicate()->rhs();
+
+                return QOrmFilterUnaryPredicate{predicate->logicalOperator(), rhs};
             }
         }
 
         Q_ORM_UNEXPECTED_STATE;
     }
 
+    static int valueClass(const QVariant& value)
+    {
+        if (!value.isValid() || value.isNull())
+            return 0;
+
+        switch (value.userType())
+        {
+            case QMetaType::Bool:
+            case QMetaType::Int:
+            case QMetaType::UInt:
+            case QMetaType::Long:
+            case QMetaType::ULong:
+            case QMetaType::LongLong:
+            case QMetaType::ULongLong:
+            case QMetaType::Short:
+            case QMetaType::UShort:
+            case QMetaType::Float:
+            case QMetaType::Double:
+                return 1;
+
+            case QMetaType::QByteArray:
+                return 3;
+
+            default:
+                return 2;
+        }
+    }
+
+    int compareValues(const QVariant& lhs, const QVariant& rhs)
+    {
+        int lhsClass = valueClass(lhs);
+        int rhsClass = valueClass(rhs);
+
+        if (lhsClass != rhsClass)
+            return lhsClass < rhsClass ? -1 : 1;
+
+        switch (lhsClass)
+        {
+            case 0:
+                return 0;
+
+            case 1:
+            {
+                bool isIntegral = lhs.userType() != QMetaType::Float &&
+                                  lhs.userType() != QMetaType::Double &&
+                                  rhs.userType() != QMetaType::Float &&
+                                  rhs.userType() != QMetaType::Double;
+
+                if (isIntegral)
+                {
+                    qlonglong l = lhs.toLongLong();
+                    qlonglong r = rhs.toLongLong();
+                    return l < r ? -1 : (r < l ? 1 : 0);
+                }
+
+                double l = lhs.toDouble();
+                double r = rhs.toDouble();
+                return l < r ? -1 : (r < l ? 1 : 0);
+            }
+
+            case 3:
+            {
+                QByteArray l = lhs.toByteArray();
+                QByteArray r = rhs.toByteArray();
+                return l < r ? -1 : (r < l ? 1 : 0);
+            }
+
+            default:
+                return lhs.toString().compare(rhs.toString());
+        }
+    }
+
+    QVariant comparablePropertyValue(const QObject* entityInstance,
+                                     const QOrmPropertyMapping& propertyMapping)
+    {
+        QVariant value = propertyMapping.qMetaProperty().read(entityInstance);
+
+        if (propertyMapping.isReference() && !propertyMapping.isTransient())
+        {
+            const QObject* referencedInstance = value.value<QObject*>();
+
+            return referencedInstance == nullptr
+                       ? QVariant{}
+                       : objectIdPropertyValue(referencedInstance,
+                                               *propertyMapping.referencedEntity());
+        }
+
+        return value;
+    }
+
+    static QVariant comparableFilterValue(const QOrmPropertyMapping& propertyMapping,
+                                          const QVariant& value)
+    {
+        if (propertyMapping.isReference() && !propertyMapping.isTransient())
+        {
+            const QObject* referencedInstance = value.value<QObject*>();
+
+            if (referencedInstance != nullptr)
+                return objectIdPropertyValue(referencedInstance,
+                                             *propertyMapping.referencedEntity());
+        }
+
+        return value;
+    }
+
+    // SQL three-valued logic: std::nullopt is the unknown result of comparisons with NULL
+    using TruthValue = std::optional<bool>;
+
+    static TruthValue evaluateTerminalPredicate(const QOrmFilterTerminalPredicate& predicate,
+                                                const QObject* entityInstance)
+    {
+        Q_ASSERT(predicate.isResolved());
+
+        // a path through a null reference compares like NULL
+        for (const QOrmPropertyMapping& reference : predicate.path())
+        {
+            entityInstance = reference.qMetaProperty().read(entityInstance).value<QObject*>();
+
+            if (entityInstance == nullptr)
+                return std::nullopt;
+        }
+
+        const QOrmPropertyMapping& propertyMapping = *predicate.propertyMapping();
+        QVariant value = comparablePropertyValue(entityInstance, propertyMapping);
+
+        if (value.isNull())
+            return std::nullopt;
+
+        if (predicate.comparison() == QOrm::Comparison::In ||
+            predicate.comparison() == QOrm::Comparison::NotIn)
+        {
+            bool isFound = false;
+            bool hasNull = false;
+
+            for (const QVariant& item : predicate.value().toList())
+            {
+                QVariant filterValue = comparableFilterValue(propertyMapping, item);
+
+                if (filterValue.isNull())
+                    hasNull = true;
+                else if (compareValues(value, filterValue) == 0)
+                    isFound = true;
+            }
+
+            // x IN (..., NULL) is unknown unless x is found
+            if (!isFound && hasNull)
+                return std::nullopt;
+
+            return predicate.comparison() == QOrm::Comparison::In ? isFound : !isFound;
+        }
+
+        QVariant filterValue = comparableFilterValue(propertyMapping, predicate.value());
+
+        if (filterValue.isNull())
+            return std::nullopt;
+
+        int result = compareValues(value, filterValue);
+
+        switch (predicate.comparison())
+        {
+            case QOrm::Comparison::Equal:
+                return result == 0;
+            case QOrm::Comparison::NotEqual:
+                return result != 0;
+            case QOrm::Comparison::Less:
+                return result < 0;
+            case QOrm::Comparison::LessOrEqual:
+                return result <= 0;
+            case QOrm::Comparison::Greater:
+                return result > 0;
+            case QOrm::Comparison::GreaterOrEqual:
+                return result >= 0;
+            case QOrm::Comparison::In:
+            case QOrm::Comparison::NotIn:
+                break;
+        }
+
+        Q_ORM_UNEXPECTED_STATE;
+    }
+
+    static TruthValue evaluateCondition(const QOrmFilterExpression& expression,
+                                        const QObject* entityInstance);
+
+    // AND is false if an operand is false, OR is true if an operand is true; otherwise an
+    // unknown operand makes the result unknown
+    template<typename Operands>
+    static TruthValue evaluateConnective(QOrm::BinaryLogicalOperator logicalOperator,
+                                         const Operands& operands,
+                                         const QObject* entityInstance)
+    {
+        const bool decisiveValue = logicalOperator == QOrm::BinaryLogicalOperator::Or;
+        bool isUnknown = false;
+
+        for (const QOrmFilterExpression& operand : operands)
+        {
+            TruthValue value = evaluateCondition(operand, entityInstance);
+
+            if (!value.has_value())
+                isUnknown = true;
+            else if (*value == decisiveValue)
+                return decisiveValue;
+        }
+
+        if (isUnknown)
+            return std::nullopt;
+
+        return !decisiveValue;
+    }
+
+    static TruthValue evaluateCondition(const QOrmFilterExpression& expression,
+                                        const QObject* entityInstance)
+    {
+        switch (expression.type())
+        {
+            case QOrm::FilterExpressionType::TerminalPredicate:
+                return evaluateTerminalPredicate(*expression.terminalPredicate(), entityInstance);
+
+            case QOrm::FilterExpressionType::BinaryPredicate:
+            {
+                const QOrmFilterBinaryPredicate* predicate = expression.binaryPredicate();
+
+                return evaluateConnective(predicate->logicalOperator(),
+                                          std::initializer_list<QOrmFilterExpression>{
+                                              predicate->lhs(), predicate->rhs()},
+                                          entityInstance);
+            }
+
+            case QOrm::FilterExpressionType::UnaryPredicate:
+            {
+                TruthValue value =
+                    evaluateCondition(expression.unaryPredicate()->rhs(), entityInstance);
+
+                // NOT unknown is unknown
+                if (!value.has_value())
+                    return std::nullopt;
+
+                return !*value;
+            }
+
+            case QOrm::FilterExpressionType::NaryPredicate:
+            {
+                const QOrmFilterNaryPredicate* predicate = expression.naryPredicate();
+
+                return evaluateConnective(predicate->logicalOperator(),
+                                          predicate->operands(),
+                                          entityInstance);
+            }
+        }
+
+        Q_ORM_UNEXPECTED_STATE;
+    }
+
+    bool evaluateFilterExpression(const QOrmFilterExpression& expression,
+                                  const QObject* entityInstance)
+    {
+        return evaluateCondition(expression, entityInstance).value_or(false);
+    }
+
+    void sortEntityInstances(QVector<QObject*>& entityInstances,
+                             const std::vector<QOrmOrder>& order,
+                             const QOrmPropertyMapping* objectIdMapping)
+    {
+        auto lessThan = [&order, objectIdMapping](const QObject* lhs, const QObject* rhs) {
+            for (const QOrmOrder& element : order)
+            {
+                int result = compareValues(comparablePropertyValue(lhs, element.mapping()),
+                                           comparablePropertyValue(rhs, element.mapping()));
+
+                if (result != 0)
+                    return element.direction() == Qt::AscendingOrder ? result < 0 : result > 0;
+            }
+
+            return objectIdMapping != nullptr &&
+                   compareValues(comparablePropertyValue(lhs, *objectIdMapping),
+                                 comparablePropertyValue(rhs, *objectIdMapping)) < 0;
+        };
+
+        std::sort(std::begin(entityInstances), std::end(entityInstances), lessThan);
+    }
+
+    QOrmQuery pushedDownQuery(const QOrmQuery& query)
+    {
+        return QOrmQuery{query.operation(),
+                         query.relation(),
+                         query.projection(),
+                         query.filter(),
+                         query.order(),
+                         query.flags()};
+    }
+
+    void applyInvokableFilters(const QOrmQuery& query, QVector<QObject*>& entityInstances)
+    {
+        auto isRejected = [&query](const QObject* instance) {
+            return std::any_of(std::cbegin(query.invokableFilters()),
+                               std::cend(query.invokableFilters()),
+                               [instance](const QOrmFilter& filter) {
+                                   return !(*filter.invokable())(instance);
+                               });
+        };
+
+        entityInstances.erase(
+            std::remove_if(std::begin(entityInstances), std::end(entityInstances), isRejected),
+            std::end(entityInstances));
+
+        int offset = qBound(0, query.offset().value_or(0), entityInstances.size());
+        int limit = query.limit().has_value()
+                        ? qBound(0, *query.limit(), entityInstances.size() - offset)
+                        : entityInstances.size() - offset;
+
+        entityInstances = entityInstances.mid(offset, limit);
+    }
+
+    static void appendValueKey(QString& key,
+                               const QOrmPropertyMapping* mapping,
+                               const QVariant& value)
+    {
+        // Referenced entity instances are represented by their object IDs so that the key does not
+        // depend on the instance identity
+        if (mapping != nullptr && mapping->isReference() && !mapping->isTransient())
+        {
+            const QObject* referencedInstance = value.value<QObject*>();
+
+            if (referencedInstance != nullptr)
+            {
+                Q_ASSERT(mapping->referencedEntity() != nullptr);
+                appendValueKey(key,
+                               nullptr,
+                               objectIdPropertyValue(referencedInstance,
+                                                     *mapping->referencedEntity()));
+                return;
+            }
+        }
+
+        key += QString::number(value.userType());
+        key += QLatin1Char(':');
+
+        if (value.userType() == qMetaTypeId<QOrmQueryParameter>())
+        {
+            key += QLatin1Char('?');
+            key += value.value<QOrmQueryParameter>().name();
+        }
+        else if (value.userType() == QMetaType::QVariantList)
+        {
+            key += QLatin1Char('[');
+
+            for (const QVariant& item : value.toList())
+            {
+                appendValueKey(key, mapping, item);
+                key += QLatin1Char(',');
+            }
+
+            key += QLatin1Char(']');
+        }
+        else if (value.canConvert<QString>())
+        {
+            QString string = value.toString();
+            key += QString::number(string.size());
+            key += QLatin1Char(':');
+            key += string;
+        }
+        else
+        {
+            QDebug dbg{&key};
+            dbg << value;
+        }
+    }
+
+    static void appendFilterExpressionKey(QString& key, const QOrmFilterExpression& expression)
+    {
+        switch (expression.type())
+        {
+            case QOrm::FilterExpressionType::TerminalPredicate:
+            {
+                const QOrmFilterTerminalPredicate* predicate = expression.terminalPredicate();
+
+                if (predicate->isResolved())
+                {
+                    for (const QOrmPropertyMapping& reference : predicate->path())
+                    {
+                        key += reference.tableFieldName();
+                        key += QLatin1Char('.');
+                    }
+
+                    key += predicate->propertyMapping()->tableFieldName();
+                }
+                else
+                {
+                    key += predicate->classProperty()->descriptor();
+                }
+
+                key += QLatin1Char('#');
+                key += QString::number(static_cast<int>(predicate->comparison()));
+                key += QLatin1Char('#');
+                appendValueKey(key, predicate->propertyMapping(), predicate->value());
+                break;
+            }
+
+            case QOrm::FilterExpressionType::BinaryPredicate:
+            {
+                const QOrmFilterBinaryPredicate* predicate = expression.binaryPredicate();
+
+                key += QLatin1Char('(');
+                appendFilterExpressionKey(key, predicate->lhs());
+                key += predicate->logicalOperator() == QOrm::BinaryLogicalOperator::And
+                           ? QLatin1String(")&(")
+                           : QLatin1String(")|(");
+                appendFilterExpressionKey(key, predicate->rhs());
+                key += QLatin1Char(')');
+                break;
+            }
+
+            case QOrm::FilterExpressionType::NaryPredicate:
+            {
+                const QOrmFilterNaryPredicate* predicate = expression.naryPredicate();
+                QLatin1String separator =
+                    predicate->logicalOperator() == QOrm::BinaryLogicalOperator::And
+                        ? QLatin1String(")&(")
+                        : QLatin1String(")|(");
+
+                key += predicate->logicalOperator() == QOrm::BinaryLogicalOperator::And
+                           ? QLatin1String("&[(")
+                           : QLatin1String("|[(");
+
+                for (int i = 0; i < predicate->operands().size(); ++i)
+                {
+                    if (i > 0)
+                        key += separator;
+
+                    appendFilterExpressionKey(key, predicate->operands()[i]);
+                }
+
+                key += QLatin1String(")]");
+                break;
+            }
+
+            case QOrm::FilterExpressionType::UnaryPredicate:
+            {
+                const QOrmFilterUnaryPredicate* predicate = expression.unaryPredicate();
+
+                key += QLatin1String("!(");
+                appendFilterExpressionKey(key, predicate->rhs());
+                key += QLatin1Char(')');
+                break;
+            }
+        }
+    }
+
+    QString filterExpressionKey(const QOrmFilterExpression& expression)
+    {
+        QString key;
+        appendFilterExpressionKey(key, expression);
+        return key;
+    }
+
+    static void appendTerminalPredicates(QVector<const QOrmFilterTerminalPredicate*>& predicates,
+                                         const QOrmFilterExpression& expression)
+    {
+        switch (expression.type())
+        {
+            case QOrm::FilterExpressionType::TerminalPredicate:
+                predicates.push_back(expression.terminalPredicate());
+                break;
+
+            case QOrm::FilterExpressionType::BinaryPredicate:
+                appendTerminalPredicates(predicates, expression.binaryPredicate()->lhs());
+                appendTerminalPredicates(predicates, expression.binaryPredicate()->rhs());
+                break;
+
+            case QOrm::FilterExpressionType::NaryPredicate:
+                for (const QOrmFilterExpression& operand : expression.naryPredicate()->operands())
+                    appendTerminalPredicates(predicates, operand);
+                break;
+
+            case QOrm::FilterExpressionType::UnaryPredicate:
+                appendTerminalPredicates(predicates, expression.unaryPredicate()->rhs());
+                break;
+        }
+    }
+
+    QVector<const QOrmFilterTerminalPredicate*> terminalPredicates(
+        const QOrmFilterExpression& expression)
+    {
+        QVector<const QOrmFilterTerminalPredicate*> predicates;
+        appendTerminalPredicates(predicates, expression);
+        return predicates;
+    }
+
     QString entityInstanceRepresentation(const QOrmMetadata& entity, const QObject* entityInstance)
     {
         QString repr;
@@ -123,122 +745,49 @@ namespace QOrmPrivate
         return repr;
     }
 
-    std::optional<QString> crossReferenceError(const QOrmMetadata& entity,
-                                               const QObject* entityInstance)
+    QVector<QVariant> entityInstanceSnapshot(const QOrmMetadata& entity,
+                                             const QObject* entityInstance)
     {
-        for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
-        {
-            if (!mapping.isReference())
-                continue;
+        const auto& propertyMappings = entity.propertyMappings();
 
-            Q_ASSERT(mapping.referencedEntity() != nullptr);
+        QVector<QVariant> snapshot;
+        snapshot.reserve(static_cast<int>(propertyMappings.size()));
 
-            const QOrmPropertyMapping* backReference = QOrmPrivate::backReference(mapping);
-            if (backReference == nullptr)
-                continue;
+        // keep the snapshot parallel to the property mappings; unmapped properties stay invalid
+        for (const QOrmPropertyMapping& mapping : propertyMappings)
+        {
+            if (mapping.isTransient() && !mapping.isReference())
+                snapshot.push_back(QVariant{});
+            else
+                snapshot.push_back(mapping.qMetaProperty().read(entityInstance));
+        }
 
-            Q_ASSERT(backReference->referencedEntity()->className() == entity.className());
+        return snapshot;
+    }
 
-            // if reference to a single instance, make sure that our instance is listed on the other
-            // side
-            if (!mapping.isTransient())
-            {
-                QObject* referencedEntity =
-                    propertyValue(entityInstance, mapping).value<QObject*>();
+    void restoreEntityInstanceSnapshot(const QOrmMetadata& entity,
+                                       QObject* entityInstance,
+                                       const QVector<QVariant>& snapshot)
+    {
+        const auto& propertyMappings = entity.propertyMappings();
+        Q_ASSERT(snapshot.size() == static_cast<int>(propertyMappings.size()));
 
-                if (referencedEntity == nullptr)
-                    continue;
+        for (int i = 0; i < snapshot.size(); ++i)
+        {
+            const QOrmPropertyMapping& mapping = propertyMappings[static_cast<size_t>(i)];
 
-                // T* <-> QVector<T*>
-                // Check that the right side contains a reference to this entity instance
-                if (backReference->isTransient())
-                {
-                    QVector<QObject*> backReferencedInstances =
-                        propertyValue(referencedEntity, *backReference).value<QVector<QObject*>>();
+            if (mapping.isTransient() && !mapping.isReference())
+                continue;
 
-                    if (std::find(std::cbegin(backReferencedInstances),
-                                  std::cend(backReferencedInstances),
-                                  entityInstance) == std::cend(backReferencedInstances))
-                    {
-                        QString errorText;
-                        QDebug dbg{&errorText};
-                        dbg.noquote().nospace()
-                            << entityInstanceRepresentation(entity, entityInstance)
-                            << " references "
-                            << entityInstanceRepresentation(*mapping.referencedEntity(),
-                                                            referencedEntity)
-                            << " but its back-reference "
-                            << shortPropertyMappingRepresentation(*backReference)
-                            << " does not contain the original instance. ";
-                        return std::make_optional(errorText);
-                    }
-                }
-                // T* <-> T*
-                // check that both sides are equal
-                else
-                {
-                    QObject* backReferencedInstance =
-                        propertyValue(referencedEntity, *backReference).value<QObject*>();
+            if (mapping.qMetaProperty().read(entityInstance) == snapshot[i])
+                continue;
 
-                    if (backReferencedInstance != entityInstance)
-                    {
-                        QString errorText;
-                        QDebug dbg{&errorText};
-                        dbg.noquote().nospace()
-                            << entityInstanceRepresentation(entity, entityInstance)
-                            << " references "
-                            << entityInstanceRepresentation(*mapping.referencedEntity(),
-                                                            referencedEntity)
-                            << " but its back-reference "
-                            << shortPropertyMappingRepresentation(*backReference)
-                            << " is set to something else.";
-                        return std::make_optional(errorText);
-                    }
-                }
-            }
-            // If list of referenced instances, check that each one has a back reference to our
-            // instance on the other side
-            else
+            if (!mapping.qMetaProperty().write(entityInstance, snapshot[i]))
             {
-                // for now, do not support n:m
-                if (backReference->isTransient())
-                {
-                    qCritical()
-                        << "QtOrm: Many-to-many relation is not supported in related entities"
-                        << mapping << "<->" << *backReference;
-                    Q_ORM_NOT_IMPLEMENTED;
-                }
-
-                QVector<QObject*> referencedInstances =
-                    propertyValue(entityInstance, mapping).value<QVector<QObject*>>();
-
-                for (const QObject* referencedInstance : referencedInstances)
-                {
-                    // QVector<T*> <-> T*
-                    // check that the entity on the other side references this one
-                    QObject* backReferencedEntity =
-                        propertyValue(referencedInstance, *backReference).value<QObject*>();
-
-                    if (backReferencedEntity != entityInstance)
-                    {
-                        QString errorText;
-                        QDebug dbg{&errorText};
-                        dbg.noquote().nospace()
-                            << entityInstanceRepresentation(entity, entityInstance)
-                            << " references "
-                            << entityInstanceRepresentation(*mapping.referencedEntity(),
-                                                            referencedInstance)
-                            << " but its back-reference "
-                            << shortPropertyMappingRepresentation(*backReference)
-                            << " is set to something else.";
-
-                        return std::make_optional(errorText);
-                    }
-                }
+                qCWarning(qtorm) << "Unable to restore" << mapping << "of"
+                                 << entityInstanceRepresentation(entity, entityInstance);
             }
         }
-
-        return std::nullopt;
     }
 } // namespace QOrmPrivate
 
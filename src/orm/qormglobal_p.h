@@ -28,13 +28,18 @@
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 
 #include <variant>
+#include <vector>
 #include <optional>
 
 QT_BEGIN_NAMESPACE
 
 class QOrmFilterExpression;
+class QOrmFilterTerminalPredicate;
+class QOrmOrder;
+class QOrmQuery;
 class QOrmRelation;
 
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
@@ -86,25 +91,54 @@ namespace QOrmPrivate
     extern QOrmFilterExpression resolvedFilterExpression(const QOrmRelation& relation,
                                                          const QOrmFilterExpression& expression);
 
+    // Three-way comparison of property values following the SQLite sort order: NULL values come
+    // first, then numeric values, then text, then binary data.
     Q_REQUIRED_RESULT
-    inline const QOrmPropertyMapping* backReference(const QOrmPropertyMapping& reference)
-    {
-        Q_ASSERT(reference.referencedEntity() != nullptr);
+    Q_ORM_EXPORT
+    extern int compareValues(const QVariant& lhs, const QVariant& rhs);
 
-        const auto& referencedPropertyMappings = reference.referencedEntity()->propertyMappings();
+    // Value of the property as it is stored in the backend: referenced entity instances are
+    // represented by their object IDs
+    Q_REQUIRED_RESULT
+    Q_ORM_EXPORT
+    extern QVariant comparablePropertyValue(const QObject* entityInstance,
+                                            const QOrmPropertyMapping& propertyMapping);
 
-        auto it = std::find_if(std::begin(referencedPropertyMappings),
-                               std::end(referencedPropertyMappings),
-                               [&reference](const QOrmPropertyMapping& propertyMapping) {
-                                   Q_ASSERT(!propertyMapping.isReference() ||
-                                            propertyMapping.referencedEntity() != nullptr);
-                                   return propertyMapping.isReference() &&
-                                          propertyMapping.referencedEntity()->className() ==
-                                              reference.enclosingEntity().className();
-                               });
+    // Evaluates a resolved filter expression against the current property values of an entity
+    // instance with the SQL semantics: comparisons with NULL are unknown, and so are NOT, AND and
+    // OR of unknown operands that do not decide the result. Only true matches.
+    Q_REQUIRED_RESULT
+    Q_ORM_EXPORT
+    extern bool evaluateFilterExpression(const QOrmFilterExpression& expression,
+                                         const QObject* entityInstance);
 
-        return it == std::end(referencedPropertyMappings) ? nullptr : &(*it);
-    }
+    // Sorts entity instances like ORDER BY, breaking ties with the object ID
+    Q_ORM_EXPORT
+    extern void sortEntityInstances(QVector<QObject*>& entityInstances,
+                                    const std::vector<QOrmOrder>& order,
+                                    const QOrmPropertyMapping* objectIdMapping);
+
+    // The part of a query with invokable filters that the backend evaluates: the query without
+    // its invokable filters, limit and offset
+    Q_REQUIRED_RESULT
+    Q_ORM_EXPORT
+    extern QOrmQuery pushedDownQuery(const QOrmQuery& query);
+
+    // Applies the invokable filters of a query to the result of its pushed down part, followed
+    // by the offset and limit
+    Q_ORM_EXPORT
+    extern void applyInvokableFilters(const QOrmQuery& query, QVector<QObject*>& entityInstances);
+
+    Q_REQUIRED_RESULT
+    Q_ORM_EXPORT
+    extern QString filterExpressionKey(const QOrmFilterExpression& expression);
+
+    // All terminal predicates of the expression in their textual order. The pointers are valid
+    // as long as the expression is alive.
+    Q_REQUIRED_RESULT
+    Q_ORM_EXPORT
+    extern QVector<const QOrmFilterTerminalPredicate*> terminalPredicates(
+        const QOrmFilterExpression& expression);
 
     Q_REQUIRED_RESULT
     Q_ORM_EXPORT
@@ -117,8 +151,13 @@ namespace QOrmPrivate
 
     Q_REQUIRED_RESULT
     Q_ORM_EXPORT
-    extern std::optional<QString> crossReferenceError(const QOrmMetadata& entity,
-                                                      const QObject* entityInstance);
+    extern QVector<QVariant> entityInstanceSnapshot(const QOrmMetadata& entity,
+                                                    const QObject* entityInstance);
+
+    Q_ORM_EXPORT
+    extern void restoreEntityInstanceSnapshot(const QOrmMetadata& entity,
+                                              QObject* entityInstance,
+                                              const QVector<QVariant>& snapshot);
 
     template<typename E>
     class Unexpected
@@ -24,9 +24,66 @@
 
 #include <QDebug>
 #include <QMetaProperty>
+#include <QStringBuilder>
 
 QT_BEGIN_NAMESPACE
 
+void QOrmMetadataPrivate::initializeStatements()
+{
+    QString values;
+
+    m_insertStatement = QStringLiteral("INSERT INTO ") % m_tableName % QLatin1Char('(');
+    m_updateStatement = QStringLiteral("UPDATE ") % m_tableName % QStringLiteral(" SET ");
+
+    for (int i = 0; i < static_cast<int>(m_propertyMappings.size()); ++i)
+    {
+        const QOrmPropertyMapping& mapping = m_propertyMappings[static_cast<size_t>(i)];
+
+        if (mapping.isTransient())
+            continue;
+
+        if (!mapping.isAutogenerated())
+        {
+            if (!m_insertMappingIndexes.empty())
+            {
+                m_insertStatement += QLatin1Char(',');
+                values += QLatin1Char(',');
+            }
+
+            m_insertStatement += mapping.tableFieldName();
+            values += QLatin1Char(':') % mapping.tableFieldName();
+            m_insertMappingIndexes.push_back(i);
+        }
+
+        if (!mapping.isObjectId())
+        {
+            if (!m_updateMappingIndexes.empty())
+                m_updateStatement += QLatin1Char(',');
+
+            m_updateStatement +=
+                mapping.tableFieldName() % QLatin1String(" = :") % mapping.tableFieldName();
+            m_updateMappingIndexes.push_back(i);
+        }
+    }
+
+    m_insertStatement += QLatin1String(") VALUES(") % values % QLatin1Char(')');
+
+    // entities without object ID cannot be updated
+    if (m_objectIdPropertyMappingIdx == -1)
+    {
+        m_updateStatement.clear();
+        m_updateMappingIndexes.clear();
+        return;
+    }
+
+    const QOrmPropertyMapping& objectIdMapping =
+        m_propertyMappings[static_cast<size_t>(m_objectIdPropertyMappingIdx)];
+
+    m_updateStatement += QLatin1String(" WHERE ") % objectIdMapping.tableFieldName() %
+                         QLatin1String(" = :") % objectIdMapping.tableFieldName();
+    m_updateMappingIndexes.push_back(m_objectIdPropertyMappingIdx);
+}
+
 QOrmMetadata::QOrmMetadata(const QOrmMetadataPrivate* data)
     : d{data}
 {
@@ -47,16 +104,21 @@ const QMetaObject& QOrmMetadata::qMetaObject() const
     return d->m_qMetaObject;
 }
 
-QString QOrmMetadata::className() const
+const QString& QOrmMetadata::className() const
 {
     return d->m_className;
 }
 
-QString QOrmMetadata::tableName() const
+const QString& QOrmMetadata::tableName() const
 {
     return d->m_tableName;
 }
 
+bool QOrmMetadata::isGadget() const
+{
+    return d->m_isGadget;
+}
+
 const std::vector<QOrmPropertyMapping>& QOrmMetadata::propertyMappings() const
 {
     return d->m_propertyMappings;
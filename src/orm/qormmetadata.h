@@ -49,8 +49,12 @@ public:
 
     Q_REQUIRED_RESULT const QMetaObject& qMetaObject() const;
 
-    Q_REQUIRED_RESULT QString className() const;
-    Q_REQUIRED_RESULT QString tableName() const;
+    Q_REQUIRED_RESULT const QString& className() const;
+    Q_REQUIRED_RESULT const QString& tableName() const;
+
+    // Q_GADGET entities are value types that are read and inserted by value, without entity
+    // instances. See QOrmQueryBuilder::selectValues() and QOrmSession::insertValues().
+    Q_REQUIRED_RESULT bool isGadget() const;
 
     Q_REQUIRED_RESULT
     const std::vector<QOrmPropertyMapping>& propertyMappings() const;
@@ -62,6 +66,8 @@ public:
     const QOrmPropertyMapping* objectIdMapping() const;
 
 private:
+    friend class QOrmMetadataPrivate;
+
     QSharedDataPointer<const QOrmMetadataPrivate> d;
 };
 
@@ -21,6 +21,7 @@
 #ifndef QORMMETADATA_P_H
 #define QORMMETADATA_P_H
 
+#include "QtOrm/qormmetadata.h"
 #include "QtOrm/qormpropertymapping.h"
 
 #include <QtCore/qshareddata.h>
@@ -35,15 +36,33 @@ public:
     {
     }
 
+    // Gives the statement generators access to the statements rendered with the metadata
+    static const QOrmMetadataPrivate* get(const QOrmMetadata& metadata)
+    {
+        return metadata.d.constData();
+    }
+
     const QMetaObject& m_qMetaObject;
 
     QString m_className;
     QString m_tableName;
+    bool m_isGadget{false};
     std::vector<QOrmPropertyMapping> m_propertyMappings;
 
     int m_objectIdPropertyMappingIdx{-1};
     QHash<QString, int> m_classPropertyMappingIndex;
     QHash<QString, int> m_tableFieldMappingIndex;
+
+    // Statements that only depend on the entity, rendered once with a :tableFieldName
+    // placeholder per column: INSERT INTO t(a,b) VALUES(:a,:b) and
+    // UPDATE t SET a = :a,b = :b WHERE id = :id
+    QString m_insertStatement;
+    QString m_updateStatement;
+    // Mappings of the placeholders in the order they appear in the statements
+    std::vector<int> m_insertMappingIndexes;
+    std::vector<int> m_updateMappingIndexes;
+
+    void initializeStatements();
 };
 
 #endif
@@ -26,13 +26,21 @@
 #include <QHash>
 #include <QMetaObject>
 #include <QMetaProperty>
+#include <QReadWriteLock>
 #include <QSet>
 #include <QVector>
 
-class QOrmMetadataCachePrivate
+#include <algorithm>
+
+// Process-wide storage of the entity metadata. The metadata is immutable once constructed and
+// shared read-only by all QOrmMetadataCache instances, so that a new session does not walk the
+// meta-objects of its entities again.
+class QOrmMetadataRegistry
 {
-    friend class QOrmMetadataCache;
+public:
+    const QOrmMetadata& find(const QMetaObject& qMetaObject);
 
+private:
     struct MappingDescriptor
     {
         QString classPropertyName;
@@ -43,10 +51,15 @@ class QOrmMetadataCachePrivate
         bool isTransient = false;
     };
 
+    QReadWriteLock m_lock;
+
+    // element references stay valid on insertion, the index points into this map
     std::unordered_map<QByteArray, QOrmMetadata> m_cache;
+    QHash<const QMetaObject*, const QOrmMetadata*> m_index;
 
     QSet<QByteArray> m_underConstruction;
-    QSet<QByteArray> m_constructed;
+    // constructed entities whose cross-references have not been resolved and validated yet
+    QHash<QByteArray, QOrmMetadataPrivate*> m_constructed;
 
     const QOrmMetadata& get(const QMetaObject& metaObject);
 
@@ -57,11 +70,41 @@ class QOrmMetadataCachePrivate
 
     void validateConstructor(const QMetaObject& qMetaObject);
 
+    void resolveBackReferences(QOrmMetadataPrivate* data);
+
     template<typename Container>
     void validateCrossReferences(Container&& entityNames);
 };
 
-const QOrmMetadata& QOrmMetadataCachePrivate::get(const QMetaObject& qMetaObject)
+Q_GLOBAL_STATIC(QOrmMetadataRegistry, metadataRegistry)
+
+class QOrmMetadataCachePrivate
+{
+    friend class QOrmMetadataCache;
+
+    // lookups already answered by the registry, to avoid locking it again
+    QHash<const QMetaObject*, const QOrmMetadata*> m_memo;
+};
+
+const QOrmMetadata& QOrmMetadataRegistry::find(const QMetaObject& qMetaObject)
+{
+    {
+        QReadLocker locker{&m_lock};
+
+        const QOrmMetadata* metadata = m_index.value(&qMetaObject, nullptr);
+
+        if (metadata != nullptr)
+            return *metadata;
+    }
+
+    QWriteLocker locker{&m_lock};
+
+    // get() checks again: another thread might have constructed it in the meantime
+    return get(qMetaObject);
+}
+
+// Requires the write lock
+const QOrmMetadata& QOrmMetadataRegistry::get(const QMetaObject& qMetaObject)
 {
     QByteArray className{qMetaObject.className()};
 
@@ -70,18 +113,29 @@ const QOrmMetadata& QOrmMetadataCachePrivate::get(const QMetaObject& qMetaObject
         initialize(className, qMetaObject);
     }
 
-    return m_cache.at(className);
+    const QOrmMetadata& metadata = m_cache.at(className);
+
+    // entities under construction are only looked up while resolving cyclic references
+    if (!m_underConstruction.contains(className))
+        m_index.insert(&qMetaObject, &metadata);
+
+    return metadata;
 }
 
-void QOrmMetadataCachePrivate::initialize(const QByteArray& className,
+void QOrmMetadataRegistry::initialize(const QByteArray& className,
                                           const QMetaObject& qMetaObject)
 {
     m_underConstruction.insert(className);
 
+    // gadgets are created by value with their default constructor
+    const bool isGadget = !qMetaObject.inherits(&QObject::staticMetaObject);
+
     // check whether the entity is creatable
-    validateConstructor(qMetaObject);
+    if (!isGadget)
+        validateConstructor(qMetaObject);
 
     QOrmMetadataPrivate* data = new QOrmMetadataPrivate{qMetaObject};
+    data->m_isGadget = isGadget;
 
     // cache the object before its actual initialization to resolve cyclic references inside the
     // mappings
@@ -99,8 +153,17 @@ void QOrmMetadataCachePrivate::initialize(const QByteArray& className,
         if (property.enclosingMetaObject() == &QObject::staticMetaObject)
             continue;
 
-        if (!property.isReadable() || !property.isWritable() || !property.hasNotifySignal() ||
-            !property.notifySignal().isValid())
+        // gadgets have no signals; their values are not tracked
+        if (isGadget && (!property.isReadable() || !property.isWritable()))
+        {
+            qFatal("QtOrm: The property %s::%s must have READ and WRITE, or MEMBER declarations "
+                   "in Q_PROPERTY().",
+                   className.data(),
+                   property.name());
+        }
+
+        if (!isGadget && (!property.isReadable() || !property.isWritable() ||
+                          !property.hasNotifySignal() || !property.notifySignal().isValid()))
         {
             qFatal("QtOrm: The property %s::%s must have READ, WRITE, and NOTIFY declarations in "
                    "Q_PROPERTY().",
@@ -110,6 +173,14 @@ void QOrmMetadataCachePrivate::initialize(const QByteArray& className,
 
         MappingDescriptor descriptor = mappingDescriptor(qMetaObject, property);
 
+        if (isGadget && descriptor.referencedEntity != nullptr)
+        {
+            qFatal("QtOrm: The property %s::%s references an entity. References are not "
+                   "supported in Q_GADGET entities.",
+                   className.data(),
+                   property.name());
+        }
+
         data->m_propertyMappings.emplace_back(m_cache.at(className),
                                               property,
                                               descriptor.classPropertyName,
@@ -128,15 +199,24 @@ void QOrmMetadataCachePrivate::initialize(const QByteArray& className,
             data->m_objectIdPropertyMappingIdx = idx;
     }
 
+    data->initializeStatements();
+
     m_underConstruction.remove(className);
-    m_constructed.insert(className);
+    m_constructed.insert(className, data);
 
-    // After all entity metadata is gathered, check their cross-reference consistency
+    // After all entity metadata is gathered, link and check their cross-references. The property
+    // mappings of referenced entities no longer move at this point.
     if (m_underConstruction.empty())
-        validateCrossReferences(m_constructed);
+    {
+        for (QOrmMetadataPrivate* constructedData : qAsConst(m_constructed))
+            resolveBackReferences(constructedData);
+
+        validateCrossReferences(m_constructed.keys());
+        m_constructed.clear();
+    }
 }
 
-QOrmMetadataCachePrivate::MappingDescriptor QOrmMetadataCachePrivate::mappingDescriptor(
+QOrmMetadataRegistry::MappingDescriptor QOrmMetadataRegistry::mappingDescriptor(
     const QMetaObject& qMetaObject,
     const QMetaProperty& property)
 {
@@ -204,12 +284,20 @@ QOrmMetadataCachePrivate::MappingDescriptor QOrmMetadataCachePrivate::mappingDes
 
         descriptor.referencedEntity = &get(*referencedMeta);
         Q_ASSERT(descriptor.referencedEntity != nullptr);
+
+        if (descriptor.referencedEntity->isGadget())
+        {
+            qFatal("QtOrm: The Q_GADGET entity %s used in %s::%s cannot be referenced",
+                   referencedMeta->className(),
+                   qMetaObject.className(),
+                   property.name());
+        }
     }
 
     return descriptor;
 }
 
-void QOrmMetadataCachePrivate::validateConstructor(const QMetaObject& qMetaObject)
+void QOrmMetadataRegistry::validateConstructor(const QMetaObject& qMetaObject)
 {
     bool hasError = false;
 
@@ -235,8 +323,30 @@ void QOrmMetadataCachePrivate::validateConstructor(const QMetaObject& qMetaObjec
     }
 }
 
+void QOrmMetadataRegistry::resolveBackReferences(QOrmMetadataPrivate* data)
+{
+    for (QOrmPropertyMapping& mapping : data->m_propertyMappings)
+    {
+        if (!mapping.isReference())
+            continue;
+
+        const auto& referencedMappings = mapping.referencedEntity()->propertyMappings();
+
+        auto it = std::find_if(std::cbegin(referencedMappings),
+                               std::cend(referencedMappings),
+                               [data](const QOrmPropertyMapping& referencedMapping) {
+                                   return referencedMapping.isReference() &&
+                                          referencedMapping.referencedEntity()->className() ==
+                                              data->m_className;
+                               });
+
+        if (it != std::cend(referencedMappings))
+            mapping.setBackReference(&(*it));
+    }
+}
+
 template<typename Container>
-void QOrmMetadataCachePrivate::validateCrossReferences(Container&& entityNames)
+void QOrmMetadataRegistry::validateCrossReferences(Container&& entityNames)
 {
     for (const QByteArray& entityClassName : entityNames)
     {
@@ -253,18 +363,7 @@ void QOrmMetadataCachePrivate::validateCrossReferences(Container&& entityNames)
             // property A*.
             if (mapping.isTransient())
             {
-                const auto& referencedMappings = mapping.referencedEntity()->propertyMappings();
-
-                auto it = std::find_if(std::cbegin(referencedMappings),
-                                       std::cend(referencedMappings),
-                                       [entityClassName](const QOrmPropertyMapping& mapping) {
-                                           // require pointer to this entity
-                                           return mapping.isReference() &&
-                                                  mapping.referencedEntity()->className() ==
-                                                      entityClassName;
-                                       });
-
-                if (it == std::cend(referencedMappings))
+                if (mapping.backReference() == nullptr)
                 {
                     qFatal("QtOrm: Entity %s referenced in %s::%s must have a back-reference "
                            "to %s. "
@@ -302,5 +401,10 @@ QOrmMetadataCache::~QOrmMetadataCache() = default;
 
 const QOrmMetadata& QOrmMetadataCache::operator[](const QMetaObject& qMetaObject)
 {
-    return d->get(qMetaObject);
+    auto it = d->m_memo.find(&qMetaObject);
+
+    if (it == std::end(d->m_memo))
+        it = d->m_memo.insert(&qMetaObject, &metadataRegistry()->find(qMetaObject));
+
+    return *it.value();
 }
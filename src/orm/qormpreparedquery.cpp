@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qormpreparedquery.h"
+#include "qormabstractprovider.h"
+#include "qormglobal_p.h"
+#include "qormsession.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace QOrmPrivate
+{
+    PreparedQueryHelper::PreparedQueryHelper(QOrmSession* session, const QOrmQuery& query)
+        : m_session{session}
+        , m_query{query}
+        , m_statement{session->prepare(query.invokableFilters().empty()
+                                           ? query
+                                           : QOrmPrivate::pushedDownQuery(query))}
+    {
+    }
+
+    void PreparedQueryHelper::bind(const QString& name, const QVariant& value)
+    {
+        m_parameterValues.insert(name, value);
+    }
+
+    const QOrmQuery& PreparedQueryHelper::query() const
+    {
+        return m_query;
+    }
+
+    QOrmQueryResult<QObject> PreparedQueryHelper::select() const
+    {
+        QOrmQueryResult<QObject> result = m_session->execute(*m_statement, m_parameterValues);
+
+        if (m_query.invokableFilters().empty() || result.error().type() != QOrm::ErrorType::None)
+            return result;
+
+        QVector<QObject*> entityInstances = result.toVector();
+        QOrmPrivate::applyInvokableFilters(m_query, entityInstances);
+
+        return QOrmQueryResult<QObject>{entityInstances};
+    }
+} // namespace QOrmPrivate
+
+QT_END_NAMESPACE
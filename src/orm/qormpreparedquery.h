@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMPREPAREDQUERY_H
+#define QORMPREPAREDQUERY_H
+
+#include <QtOrm/qormglobal.h>
+#include <QtOrm/qormquery.h>
+#include <QtOrm/qormqueryparameter.h>
+#include <QtOrm/qormqueryresult.h>
+
+#include <QtCore/qvariant.h>
+
+#include <memory>
+#include <type_traits>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmPreparedStatement;
+class QOrmSession;
+
+namespace QOrmPrivate
+{
+    class Q_ORM_EXPORT PreparedQueryHelper
+    {
+    public:
+        PreparedQueryHelper(QOrmSession* session, const QOrmQuery& query);
+
+        void bind(const QString& name, const QVariant& value);
+
+        Q_REQUIRED_RESULT
+        const QOrmQuery& query() const;
+
+        Q_REQUIRED_RESULT
+        QOrmQueryResult<QObject> select() const;
+
+    private:
+        QOrmSession* m_session{nullptr};
+        QOrmQuery m_query;
+        std::shared_ptr<QOrmPreparedStatement> m_statement;
+        QVariantMap m_parameterValues;
+    };
+} // namespace QOrmPrivate
+
+// A read query that is resolved and rendered once, and executed with the values bound to its
+// QOrmQueryParameter placeholders. Copies share the prepared statement.
+template<typename T>
+class QOrmPreparedQuery
+{
+public:
+    using Projection = T;
+
+    explicit QOrmPreparedQuery(QOrmPrivate::PreparedQueryHelper helper)
+        : m_helper{std::move(helper)}
+    {
+    }
+
+    template<typename V>
+    QOrmPreparedQuery& bind(const QString& name, V&& value)
+    {
+        if constexpr (std::is_convertible_v<V, QVariant>)
+            m_helper.bind(name, QVariant{std::forward<V>(value)});
+        else
+            m_helper.bind(name, QVariant::fromValue(value));
+
+        return *this;
+    }
+
+    Q_REQUIRED_RESULT
+    const QOrmQuery& query() const { return m_helper.query(); }
+
+    Q_REQUIRED_RESULT
+    QOrmQueryResult<Projection> select() const { return m_helper.select(); }
+
+private:
+    QOrmPrivate::PreparedQueryHelper m_helper;
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMPREPAREDQUERY_H
@@ -79,6 +79,7 @@ class QOrmPropertyMappingPrivate : public QSharedData
     QVariant::Type m_dataType{QVariant::Invalid};
     const QOrmMetadata* m_referencedEntity{nullptr};
     bool m_isTransient{false};
+    const QOrmPropertyMapping* m_backReference{nullptr};
 };
 
 QOrmPropertyMapping::QOrmPropertyMapping(const QOrmMetadata& enclosingEntity,
@@ -122,12 +123,12 @@ const QMetaProperty& QOrmPropertyMapping::qMetaProperty() const
     return d->m_qMetaProperty;
 }
 
-QString QOrmPropertyMapping::classPropertyName() const
+const QString& QOrmPropertyMapping::classPropertyName() const
 {
     return d->m_classPropertyName;
 }
 
-QString QOrmPropertyMapping::tableFieldName() const
+const QString& QOrmPropertyMapping::tableFieldName() const
 {
     return d->m_tableFieldName;
 }
@@ -167,4 +168,14 @@ bool QOrmPropertyMapping::isTransient() const
     return d->m_isTransient;
 }
 
+const QOrmPropertyMapping* QOrmPropertyMapping::backReference() const
+{
+    return d->m_backReference;
+}
+
+void QOrmPropertyMapping::setBackReference(const QOrmPropertyMapping* backReference)
+{
+    d->m_backReference = backReference;
+}
+
 QT_END_NAMESPACE
@@ -31,10 +31,13 @@
 QT_BEGIN_NAMESPACE
 
 class QOrmMetadata;
+class QOrmMetadataRegistry;
 class QOrmPropertyMappingPrivate;
 
 class Q_ORM_EXPORT QOrmPropertyMapping
 {
+    friend class QOrmMetadataRegistry;
+
 public:
     QOrmPropertyMapping(const QOrmMetadata& enclosingEntity,
                         QMetaProperty qMetaProperty,
@@ -59,10 +62,10 @@ public:
     const QMetaProperty& qMetaProperty() const;
 
     Q_REQUIRED_RESULT
-    QString classPropertyName() const;
+    const QString& classPropertyName() const;
 
     Q_REQUIRED_RESULT
-    QString tableFieldName() const;
+    const QString& tableFieldName() const;
 
     Q_REQUIRED_RESULT
     bool isObjectId() const;
@@ -85,7 +88,14 @@ public:
     Q_REQUIRED_RESULT
     bool isTransient() const;
 
+    // The property of the referenced entity that refers back to the enclosing entity, or nullptr
+    // if this is not a reference or the relation is unidirectional
+    Q_REQUIRED_RESULT
+    const QOrmPropertyMapping* backReference() const;
+
 private:
+    void setBackReference(const QOrmPropertyMapping* backReference);
+
     QSharedDataPointer<QOrmPropertyMappingPrivate> d;
 };
 
@@ -36,13 +36,19 @@ public:
                      const std::optional<QOrmMetadata>& projection,
                      const std::optional<QOrmFilter>& filter,
                      const std::vector<QOrmOrder>& order,
-                     const QFlags<QOrm::QueryFlags>& flags)
+                     const QFlags<QOrm::QueryFlags>& flags,
+                     std::optional<int> limit,
+                     std::optional<int> offset,
+                     const std::vector<QOrmFilter>& invokableFilters)
         : m_operation{operation}
         , m_relation{relation}
         , m_projection{projection}
         , m_filter{filter}
         , m_order{order}
         , m_flags{flags}
+        , m_limit{limit}
+        , m_offset{offset}
+        , m_invokableFilters{invokableFilters}
     {
     }
 
@@ -62,6 +68,9 @@ public:
     std::vector<QOrmOrder> m_order;
     QObject* m_entityInstance{nullptr};
     QFlags<QOrm::QueryFlags> m_flags;
+    std::optional<int> m_limit;
+    std::optional<int> m_offset;
+    std::vector<QOrmFilter> m_invokableFilters;
 };
 
 QOrmQuery::QOrmQuery(QOrm::Operation operation,
@@ -69,8 +78,12 @@ QOrmQuery::QOrmQuery(QOrm::Operation operation,
                      const std::optional<QOrmMetadata>& projection,
                      const std::optional<QOrmFilter>& filter,
                      const std::vector<QOrmOrder>& order,
-                     const QFlags<QOrm::QueryFlags>& flags)
-    : d{new QOrmQueryPrivate{operation, relation, projection, filter, order, flags}}
+                     const QFlags<QOrm::QueryFlags>& flags,
+                     std::optional<int> limit,
+                     std::optional<int> offset,
+                     const std::vector<QOrmFilter>& invokableFilters)
+    : d{new QOrmQueryPrivate{
+          operation, relation, projection, filter, order, flags, limit, offset, invokableFilters}}
 {
 }
 
@@ -111,6 +124,11 @@ const std::optional<QOrmFilter>& QOrmQuery::filter() const
     return d->m_filter;
 }
 
+const std::vector<QOrmFilter>& QOrmQuery::invokableFilters() const
+{
+    return d->m_invokableFilters;
+}
+
 const std::vector<QOrmOrder>& QOrmQuery::order() const
 {
     return d->m_order;
@@ -126,6 +144,16 @@ const QFlags<QOrm::QueryFlags>& QOrmQuery::flags() const
     return d->m_flags;
 }
 
+std::optional<int> QOrmQuery::limit() const
+{
+    return d->m_limit;
+}
+
+std::optional<int> QOrmQuery::offset() const
+{
+    return d->m_offset;
+}
+
 QDebug operator<<(QDebug dbg, const QOrmQuery& query)
 {
     QDebugStateSaver saver{dbg};
@@ -138,9 +166,18 @@ QDebug operator<<(QDebug dbg, const QOrmQuery& query)
     if (query.filter().has_value())
         dbg << ", " << *query.filter();
 
+    for (const QOrmFilter& filter : query.invokableFilters())
+        dbg << ", " << filter;
+
     if (!query.order().empty())
         dbg << ", " << query.order();
 
+    if (query.limit().has_value())
+        dbg << ", limit " << *query.limit();
+
+    if (query.offset().has_value())
+        dbg << ", offset " << *query.offset();
+
     if (query.entityInstance() != nullptr)
         dbg << ", " << query.entityInstance();
 
@@ -46,7 +46,10 @@ public:
               const std::optional<QOrmMetadata>& projection,
               const std::optional<QOrmFilter>& filter,
               const std::vector<QOrmOrder>& order,
-              const QFlags<QOrm::QueryFlags>& flags);
+              const QFlags<QOrm::QueryFlags>& flags,
+              std::optional<int> limit = std::nullopt,
+              std::optional<int> offset = std::nullopt,
+              const std::vector<QOrmFilter>& invokableFilters = {});
     QOrmQuery(QOrm::Operation operation, const QOrmMetadata& relation, QObject* entityInstance);
     QOrmQuery(const QOrmQuery&);
     QOrmQuery(QOrmQuery&&);
@@ -67,6 +70,10 @@ public:
     Q_REQUIRED_RESULT
     const std::optional<QOrmFilter>& filter() const;
 
+    // Filters evaluated on the hydrated instances that passed filter(), before limit and offset
+    Q_REQUIRED_RESULT
+    const std::vector<QOrmFilter>& invokableFilters() const;
+
     Q_REQUIRED_RESULT
     const std::vector<QOrmOrder>& order() const;
 
@@ -76,6 +83,12 @@ public:
     Q_REQUIRED_RESULT
     const QFlags<QOrm::QueryFlags>& flags() const;
 
+    Q_REQUIRED_RESULT
+    std::optional<int> limit() const;
+
+    Q_REQUIRED_RESULT
+    std::optional<int> offset() const;
+
 private:
     QSharedDataPointer<QOrmQueryPrivate> d;
 };
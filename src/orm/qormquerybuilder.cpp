@@ -27,9 +27,11 @@
 #include "qormglobal_p.h"
 #include "qormmetadatacache.h"
 #include "qormorder.h"
+#include "qormpropertymapping.h"
 #include "qormquery.h"
 #include "qormqueryresult.h"
 #include "qormrelation.h"
+#include "qormrowset.h"
 #include "qormsession.h"
 
 #include <QDebug>
@@ -42,32 +44,48 @@ namespace QOrmPrivate
     static std::optional<QOrmFilter> foldFilters(const QOrmRelation& relation,
                                                  const ForwardIterable& filters)
     {
-        return std::accumulate(
-            std::cbegin(filters),
-            std::cend(filters),
-            std::optional<QOrmFilter>{},
-            [relation](std::optional<QOrmFilter> lhs,
-                       const QOrmFilter& rhs) -> std::optional<QOrmFilter> {
-                if (rhs.type() != QOrm::FilterType::Expression)
-                    return lhs;
-
-                Q_ASSERT(rhs.expression() != nullptr);
-
-                if (!lhs.has_value())
-                {
-                    return QOrmFilter{
-                        QOrmPrivate::resolvedFilterExpression(relation, *rhs.expression())};
-                }
-                else
-                {
-                    Q_ASSERT(lhs->type() == QOrm::FilterType::Expression);
-                    Q_ASSERT(lhs->expression() != nullptr);
-
-                    return QOrmFilter{
-                        *lhs->expression() &&
-                        QOrmPrivate::resolvedFilterExpression(relation, *rhs.expression())};
-                }
-            });
+        QVector<QOrmFilterExpression> expressions;
+
+        for (const QOrmFilter& filter : filters)
+        {
+            if (filter.type() != QOrm::FilterType::Expression)
+                continue;
+
+            Q_ASSERT(filter.expression() != nullptr);
+            expressions.push_back(*filter.expression());
+        }
+
+        if (expressions.isEmpty())
+            return std::nullopt;
+
+        // Resolution flattens the conjunction of all filters into a single n-ary predicate
+        QOrmFilterExpression expression = QOrmPrivate::resolvedFilterExpression(
+            relation,
+            QOrmFilterNaryPredicate{QOrm::BinaryLogicalOperator::And, expressions});
+
+        const QOrmFilterNaryPredicate* nary = expression.naryPredicate();
+
+        if (nary != nullptr && nary->logicalOperator() == QOrm::BinaryLogicalOperator::And &&
+            nary->operands().isEmpty())
+        {
+            return std::nullopt;
+        }
+
+        return QOrmFilter{expression};
+    }
+
+    template<typename ForwardIterable>
+    static std::vector<QOrmFilter> invokableFilters(const ForwardIterable& filters)
+    {
+        std::vector<QOrmFilter> result;
+
+        for (const QOrmFilter& filter : filters)
+        {
+            if (filter.type() == QOrm::FilterType::Invokable)
+                result.push_back(filter);
+        }
+
+        return result;
     }
 
     class QueryBuilderHelperPrivate
@@ -89,6 +107,8 @@ namespace QOrmPrivate
         QObject* m_entityInstance{nullptr};
         std::vector<QOrmFilter> m_filters;
         std::vector<QOrmOrder> m_order;
+        std::optional<int> m_limit;
+        std::optional<int> m_offset;
     };
 
     QueryBuilderHelper::QueryBuilderHelper(QOrmSession* ormSession, const QOrmRelation& relation)
@@ -125,7 +145,20 @@ namespace QOrmPrivate
         d->m_order.emplace_back(*mapping, direction);
     }
 
-    QOrmQuery QueryBuilderHelper::build(QOrm::Operation operation, QOrm::QueryFlags flags) const
+    void QueryBuilderHelper::setLimit(int limit)
+    {
+        Q_ASSERT(limit >= 0);
+        d->m_limit = limit;
+    }
+
+    void QueryBuilderHelper::setOffset(int offset)
+    {
+        Q_ASSERT(offset >= 0);
+        d->m_offset = offset;
+    }
+
+    QOrmQuery QueryBuilderHelper::build(QOrm::Operation operation,
+                                        const QFlags<QOrm::QueryFlags>& flags) const
     {
         if (operation == QOrm::Operation::Merge || operation == QOrm::Operation::Create ||
             operation == QOrm::Operation::Update ||
@@ -139,21 +172,93 @@ namespace QOrmPrivate
                  (operation == QOrm::Operation::Delete &&
                   d->m_relation.type() == QOrm::RelationType::Query))
         {
+            std::vector<QOrmFilter> invokables = invokableFilters(d->m_filters);
+
+            if (operation != QOrm::Operation::Read && !invokables.empty())
+                qFatal("QtOrm: invokable filters are only supported in read queries");
+
             return QOrmQuery{operation,
                              d->m_relation,
                              d->m_projection,
                              foldFilters(d->m_relation, d->m_filters),
                              d->m_order,
-                             flags};
+                             flags,
+                             d->m_limit,
+                             d->m_offset,
+                             invokables};
         }
 
         qFatal("Unexpected state");
     }
 
-    QOrmQueryResult<QObject> QueryBuilderHelper::select(QOrm::QueryFlags flags) const
+    QOrmQueryResult<QObject> QueryBuilderHelper::select(const QFlags<QOrm::QueryFlags>& flags) const
     {
         return d->m_session->execute(build(QOrm::Operation::Read, flags));
     }
+
+    PreparedQueryHelper QueryBuilderHelper::prepare(const QFlags<QOrm::QueryFlags>& flags) const
+    {
+        return PreparedQueryHelper{d->m_session, build(QOrm::Operation::Read, flags)};
+    }
+
+    QOrmRowSet QueryBuilderHelper::selectColumns(
+        const std::vector<QOrmClassProperty>& classProperties) const
+    {
+        Q_ASSERT(d->m_projection.has_value());
+
+        std::vector<QOrmPropertyMapping> columns;
+        columns.reserve(classProperties.size());
+
+        for (const QOrmClassProperty& classProperty : classProperties)
+        {
+            const QOrmPropertyMapping* mapping =
+                d->m_projection->classPropertyMapping(classProperty.descriptor());
+
+            if (mapping == nullptr || mapping->isTransient())
+            {
+                qFatal("QtOrm: %s is not a column of %s",
+                       qPrintable(classProperty.descriptor()),
+                       qPrintable(d->m_projection->className()));
+            }
+
+            columns.push_back(*mapping);
+        }
+
+        return selectRowSet(columns);
+    }
+
+    QOrmRowSet QueryBuilderHelper::selectValues() const
+    {
+        Q_ASSERT(d->m_projection.has_value());
+
+        if (!d->m_projection->isGadget())
+        {
+            qFatal("QtOrm: %s is not a Q_GADGET entity, use select() instead",
+                   qPrintable(d->m_projection->className()));
+        }
+
+        std::vector<QOrmPropertyMapping> columns;
+        columns.reserve(d->m_projection->propertyMappings().size());
+
+        for (const QOrmPropertyMapping& mapping : d->m_projection->propertyMappings())
+        {
+            if (!mapping.isTransient())
+                columns.push_back(mapping);
+        }
+
+        return selectRowSet(columns);
+    }
+
+    QOrmRowSet QueryBuilderHelper::selectRowSet(
+        const std::vector<QOrmPropertyMapping>& columns) const
+    {
+        QOrmQuery query = build(QOrm::Operation::Read, QOrm::QueryFlags::None);
+
+        if (!query.invokableFilters().empty())
+            qFatal("QtOrm: invokable filters are not supported when selecting columns or values");
+
+        return d->m_session->executeRowSet(query, columns);
+    }
 } // namespace QOrmPrivate
 
 QT_END_NAMESPACE
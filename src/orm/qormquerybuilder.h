@@ -24,20 +24,28 @@
 #include <QtOrm/qormfilter.h>
 #include <QtOrm/qormfilterexpression.h>
 #include <QtOrm/qormglobal.h>
+#include <QtOrm/qormpreparedquery.h>
 #include <QtOrm/qormquery.h>
 #include <QtOrm/qormqueryresult.h>
+#include <QtOrm/qormrowset.h>
+#include <QtOrm/qormvalueresult.h>
 
 #include <QtCore/qobject.h>
 #include <QtCore/qshareddata.h>
 #include <QtCore/qvector.h>
 
+#include <functional>
+#include <initializer_list>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
 class QOrmAbstractProvider;
 class QOrmFilterExpression;
 class QOrmMetadataCache;
+class QOrmPropertyMapping;
 class QOrmQueryBuilderPrivate;
 class QOrmRelation;
 class QOrmSession;
@@ -60,14 +68,27 @@ namespace QOrmPrivate
         void setInstance(const QMetaObject& qMetaObject, QObject* instance);
         void addFilter(const QOrmFilter& filter);
         void addOrder(const QOrmClassProperty& classProperty, Qt::SortOrder direction);
+        void setLimit(int limit);
+        void setOffset(int offset);
 
         Q_REQUIRED_RESULT
-        QOrmQuery build(QOrm::Operation operation, QOrm::QueryFlags flags) const;
+        QOrmQuery build(QOrm::Operation operation, const QFlags<QOrm::QueryFlags>& flags) const;
 
         Q_REQUIRED_RESULT
-        QOrmQueryResult<QObject> select(QOrm::QueryFlags flags) const;
+        QOrmQueryResult<QObject> select(const QFlags<QOrm::QueryFlags>& flags) const;
+
+        Q_REQUIRED_RESULT
+        PreparedQueryHelper prepare(const QFlags<QOrm::QueryFlags>& flags) const;
+
+        Q_REQUIRED_RESULT
+        QOrmRowSet selectColumns(const std::vector<QOrmClassProperty>& classProperties) const;
+
+        Q_REQUIRED_RESULT
+        QOrmRowSet selectValues() const;
 
     private:
+        QOrmRowSet selectRowSet(const std::vector<QOrmPropertyMapping>& columns) const;
+
         std::unique_ptr<QueryBuilderHelperPrivate> d;
     };
 } // namespace QOrmPrivate
@@ -104,6 +125,18 @@ public:
         return *this;
     }
 
+    // The predicate runs on the instances that pass the expression filters in the backend
+    template<typename F,
+             typename = std::enable_if_t<std::is_invocable_r_v<bool, F, const Projection*>>>
+    QOrmQueryBuilder& filter(F predicate)
+    {
+        m_helper.addFilter(QOrmFilter{std::function<bool(const QObject*)>{
+            [predicate = std::move(predicate)](const QObject* instance) {
+                return std::invoke(predicate, qobject_cast<const Projection*>(instance));
+            }}});
+        return *this;
+    }
+
     QOrmQueryBuilder& order(const QOrmClassProperty& classProperty,
                             Qt::SortOrder direction = Qt::AscendingOrder)
     {
@@ -111,6 +144,18 @@ public:
         return *this;
     }
 
+    QOrmQueryBuilder& limit(int limit)
+    {
+        m_helper.setLimit(limit);
+        return *this;
+    }
+
+    QOrmQueryBuilder& offset(int offset)
+    {
+        m_helper.setOffset(offset);
+        return *this;
+    }
+
     QOrmQueryBuilder& instance(const QMetaObject& qMetaObject, QObject* instance)
     {
         m_helper.setInstance(qMetaObject, instance);
@@ -118,10 +163,39 @@ public:
     }
 
     Q_REQUIRED_RESULT
-    QOrmQueryResult<Projection> select(QOrm::QueryFlags flags = QOrm::QueryFlags::None) const { return m_helper.select(flags); }
+    QOrmQueryResult<Projection> select(
+        const QFlags<QOrm::QueryFlags>& flags = QOrm::QueryFlags::None) const
+    {
+        return m_helper.select(flags);
+    }
 
+    // Reads only the values of the properties, in their order, instead of entity instances
     Q_REQUIRED_RESULT
-    QOrmQuery build(QOrm::Operation operation, QOrm::QueryFlags flags = QOrm::QueryFlags::None) const { return m_helper.build(operation, flags); }
+    QOrmRowSet selectColumns(std::initializer_list<QOrmClassProperty> classProperties) const
+    {
+        return m_helper.selectColumns(std::vector<QOrmClassProperty>{classProperties});
+    }
+
+    // Reads the rows of a Q_GADGET entity by value
+    Q_REQUIRED_RESULT
+    QOrmValueResult<Projection> selectValues() const
+    {
+        return QOrmValueResult<Projection>{m_helper.selectValues()};
+    }
+
+    Q_REQUIRED_RESULT
+    QOrmPreparedQuery<Projection> prepare(
+        const QFlags<QOrm::QueryFlags>& flags = QOrm::QueryFlags::None) const
+    {
+        return QOrmPreparedQuery<Projection>{m_helper.prepare(flags)};
+    }
+
+    Q_REQUIRED_RESULT
+    QOrmQuery build(QOrm::Operation operation,
+                    const QFlags<QOrm::QueryFlags>& flags = QOrm::QueryFlags::None) const
+    {
+        return m_helper.build(operation, flags);
+    }
 
 private:
     QOrmPrivate::QueryBuilderHelper m_helper;
@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qormquerycache.h"
+
+#include "qormfilter.h"
+#include "qormglobal_p.h"
+#include "qormmetadata.h"
+#include "qormorder.h"
+#include "qormquery.h"
+#include "qormrelation.h"
+
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmQueryCachePrivate
+{
+    friend class QOrmQueryCache;
+
+    struct Entry
+    {
+        QVector<QVariant> objectIds;
+        QStringList tableNames;
+    };
+
+    explicit QOrmQueryCachePrivate(int maxMemoryUsage)
+        : m_entries{maxMemoryUsage}
+    {
+    }
+
+    static void appendQueryKey(QString& key, const QOrmQuery& query);
+    static void collectTableNames(QStringList& tableNames, const QOrmQuery& query);
+    static int estimatedCost(const QString& key, const Entry& entry);
+
+    mutable QMutex m_mutex;
+    QCache<QString, Entry> m_entries;
+    QHash<QString, QSet<QString>> m_keysByTableName;
+    // generation of the last invalidation per table, and of the last clear()
+    quint64 m_generation{0};
+    QHash<QString, quint64> m_tableGenerations;
+    quint64 m_clearGeneration{0};
+    quint64 m_hitCount{0};
+    quint64 m_missCount{0};
+};
+
+void QOrmQueryCachePrivate::appendQueryKey(QString& key, const QOrmQuery& query)
+{
+    switch (query.relation().type())
+    {
+        case QOrm::RelationType::Mapping:
+            key += query.relation().mapping()->tableName();
+            break;
+
+        case QOrm::RelationType::Query:
+            key += QLatin1Char('(');
+            appendQueryKey(key, *query.relation().query());
+            key += QLatin1Char(')');
+            break;
+    }
+
+    key += QLatin1String("|P:");
+    if (query.projection().has_value())
+        key += query.projection()->className();
+
+    key += QLatin1String("|F:");
+    if (query.filter().has_value() && query.filter()->type() == QOrm::FilterType::Expression)
+        key += QOrmPrivate::filterExpressionKey(*query.filter()->expression());
+
+    key += QLatin1String("|O:");
+    for (const QOrmOrder& order : query.order())
+    {
+        key += order.mapping().tableFieldName();
+        key += order.direction() == Qt::AscendingOrder ? QLatin1String("+,")
+                                                       : QLatin1String("-,");
+    }
+
+    key += QLatin1String("|L:");
+    if (query.limit().has_value())
+        key += QString::number(*query.limit());
+
+    key += QLatin1String("|S:");
+    if (query.offset().has_value())
+        key += QString::number(*query.offset());
+
+    key += QLatin1String("|Q:");
+    key += QString::number(static_cast<int>(query.flags()));
+}
+
+void QOrmQueryCachePrivate::collectTableNames(QStringList& tableNames, const QOrmQuery& query)
+{
+    switch (query.relation().type())
+    {
+        case QOrm::RelationType::Mapping:
+            if (!tableNames.contains(query.relation().mapping()->tableName()))
+                tableNames.push_back(query.relation().mapping()->tableName());
+            break;
+
+        case QOrm::RelationType::Query:
+            collectTableNames(tableNames, *query.relation().query());
+            break;
+    }
+
+    if (query.projection().has_value() && !tableNames.contains(query.projection()->tableName()))
+        tableNames.push_back(query.projection()->tableName());
+
+    // tables joined by filters on property paths
+    if (query.filter().has_value() && query.filter()->type() == QOrm::FilterType::Expression)
+    {
+        const auto predicates = QOrmPrivate::terminalPredicates(*query.filter()->expression());
+
+        for (const QOrmFilterTerminalPredicate* predicate : predicates)
+        {
+            for (const QOrmPropertyMapping& reference : predicate->path())
+            {
+                QString tableName = reference.referencedEntity()->tableName();
+
+                if (!tableNames.contains(tableName))
+                    tableNames.push_back(tableName);
+            }
+        }
+    }
+}
+
+int QOrmQueryCachePrivate::estimatedCost(const QString& key, const Entry& entry)
+{
+    int cost = static_cast<int>(sizeof(Entry)) + key.size() * static_cast<int>(sizeof(QChar));
+
+    for (const QVariant& objectId : entry.objectIds)
+    {
+        cost += static_cast<int>(sizeof(QVariant));
+
+        if (objectId.userType() == QMetaType::QString)
+            cost += objectId.toString().size() * static_cast<int>(sizeof(QChar));
+    }
+
+    for (const QString& tableName : entry.tableNames)
+        cost += static_cast<int>(sizeof(QString)) + tableName.size() * static_cast<int>(sizeof(QChar));
+
+    return cost;
+}
+
+QOrmQueryCache::QOrmQueryCache(int maxMemoryUsage)
+    : d{new QOrmQueryCachePrivate{maxMemoryUsage}}
+{
+}
+
+QOrmQueryCache::~QOrmQueryCache() = default;
+
+bool QOrmQueryCache::isCacheable(const QOrmQuery& query)
+{
+    if (query.operation() != QOrm::Operation::Read)
+        return false;
+
+    if (!query.projection().has_value() || query.projection()->objectIdMapping() == nullptr)
+        return false;
+
+    if (query.flags().testFlag(QOrm::QueryFlags::OverwriteCachedInstances) ||
+        query.flags().testFlag(QOrm::QueryFlags::NoTracking))
+    {
+        return false;
+    }
+
+    if (query.filter().has_value() && query.filter()->type() != QOrm::FilterType::Expression)
+        return false;
+
+    if (!query.invokableFilters().empty())
+        return false;
+
+    return query.relation().type() == QOrm::RelationType::Mapping ||
+           isCacheable(*query.relation().query());
+}
+
+std::optional<QVector<QVariant>> QOrmQueryCache::find(const QOrmQuery& query)
+{
+    QString key;
+    QOrmQueryCachePrivate::appendQueryKey(key, query);
+
+    QMutexLocker locker{&d->m_mutex};
+
+    const QOrmQueryCachePrivate::Entry* entry = d->m_entries.object(key);
+
+    if (entry == nullptr)
+    {
+        ++d->m_missCount;
+        return std::nullopt;
+    }
+
+    ++d->m_hitCount;
+    return std::make_optional(entry->objectIds);
+}
+
+quint64 QOrmQueryCache::generation() const
+{
+    QMutexLocker locker{&d->m_mutex};
+    return d->m_generation;
+}
+
+void QOrmQueryCache::insert(const QOrmQuery& query,
+                            const QVector<QVariant>& objectIds,
+                            quint64 generation)
+{
+    Q_ASSERT(isCacheable(query));
+
+    QString key;
+    QOrmQueryCachePrivate::appendQueryKey(key, query);
+
+    auto* entry = new QOrmQueryCachePrivate::Entry{objectIds, {}};
+    QOrmQueryCachePrivate::collectTableNames(entry->tableNames, query);
+
+    int cost = QOrmQueryCachePrivate::estimatedCost(key, *entry);
+
+    QMutexLocker locker{&d->m_mutex};
+
+    // the result was read before a concurrent invalidation and may be stale
+    bool isStale = generation < d->m_clearGeneration;
+
+    for (const QString& tableName : qAsConst(entry->tableNames))
+        isStale = isStale || d->m_tableGenerations.value(tableName, 0) > generation;
+
+    if (isStale)
+    {
+        delete entry;
+        return;
+    }
+
+    for (const QString& tableName : qAsConst(entry->tableNames))
+        d->m_keysByTableName[tableName].insert(key);
+
+    // QCache takes the ownership of the entry and deletes it if it does not fit
+    d->m_entries.insert(key, entry, cost);
+}
+
+void QOrmQueryCache::invalidate(const QString& tableName)
+{
+    QMutexLocker locker{&d->m_mutex};
+
+    d->m_tableGenerations.insert(tableName, ++d->m_generation);
+
+    auto it = d->m_keysByTableName.find(tableName);
+
+    if (it == std::end(d->m_keysByTableName))
+        return;
+
+    // keys of entries evicted by QCache may still be listed here; removing them is a no-op
+    for (const QString& key : qAsConst(it.value()))
+        d->m_entries.remove(key);
+
+    d->m_keysByTableName.erase(it);
+}
+
+void QOrmQueryCache::clear()
+{
+    QMutexLocker locker{&d->m_mutex};
+
+    d->m_entries.clear();
+    d->m_keysByTableName.clear();
+    d->m_clearGeneration = ++d->m_generation;
+}
+
+int QOrmQueryCache::count() const
+{
+    QMutexLocker locker{&d->m_mutex};
+    return d->m_entries.count();
+}
+
+int QOrmQueryCache::maxMemoryUsage() const
+{
+    QMutexLocker locker{&d->m_mutex};
+    return d->m_entries.maxCost();
+}
+
+void QOrmQueryCache::setMaxMemoryUsage(int maxMemoryUsage)
+{
+    QMutexLocker locker{&d->m_mutex};
+    d->m_entries.setMaxCost(maxMemoryUsage);
+}
+
+int QOrmQueryCache::memoryUsage() const
+{
+    QMutexLocker locker{&d->m_mutex};
+    return d->m_entries.totalCost();
+}
+
+quint64 QOrmQueryCache::hitCount() const
+{
+    QMutexLocker locker{&d->m_mutex};
+    return d->m_hitCount;
+}
+
+quint64 QOrmQueryCache::missCount() const
+{
+    QMutexLocker locker{&d->m_mutex};
+    return d->m_missCount;
+}
+
+qreal QOrmQueryCache::hitRatio() const
+{
+    QMutexLocker locker{&d->m_mutex};
+
+    quint64 lookupCount = d->m_hitCount + d->m_missCount;
+    return lookupCount == 0 ? 0.0 : static_cast<qreal>(d->m_hitCount) / lookupCount;
+}
+
+void QOrmQueryCache::resetStatistics()
+{
+    QMutexLocker locker{&d->m_mutex};
+
+    d->m_hitCount = 0;
+    d->m_missCount = 0;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMQUERYCACHE_H
+#define QORMQUERYCACHE_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+#include <optional>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmQuery;
+class QOrmQueryCachePrivate;
+
+// Second-level cache of read query results. Stores the object IDs of the entity instances returned
+// by a query; the instances themselves are resolved through the entity instance cache of the
+// session. The cache can be shared between sessions and is thread-safe.
+class Q_ORM_EXPORT QOrmQueryCache
+{
+    Q_DISABLE_COPY(QOrmQueryCache)
+
+public:
+    explicit QOrmQueryCache(int maxMemoryUsage = 4 * 1024 * 1024);
+    ~QOrmQueryCache();
+
+    Q_REQUIRED_RESULT
+    static bool isCacheable(const QOrmQuery& query);
+
+    Q_REQUIRED_RESULT
+    std::optional<QVector<QVariant>> find(const QOrmQuery& query);
+
+    // Current generation of the cache, to be taken before reading the result to insert. The
+    // result is dropped if a table of the query was invalidated since then.
+    Q_REQUIRED_RESULT
+    quint64 generation() const;
+    void insert(const QOrmQuery& query, const QVector<QVariant>& objectIds, quint64 generation);
+
+    void invalidate(const QString& tableName);
+    void clear();
+
+    Q_REQUIRED_RESULT
+    int count() const;
+
+    Q_REQUIRED_RESULT
+    int maxMemoryUsage() const;
+    void setMaxMemoryUsage(int maxMemoryUsage);
+
+    Q_REQUIRED_RESULT
+    int memoryUsage() const;
+
+    Q_REQUIRED_RESULT
+    quint64 hitCount() const;
+
+    Q_REQUIRED_RESULT
+    quint64 missCount() const;
+
+    Q_REQUIRED_RESULT
+    qreal hitRatio() const;
+
+    void resetStatistics();
+
+private:
+    QScopedPointer<QOrmQueryCachePrivate> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMQUERYCACHE_H
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMQUERYPARAMETER_H
+#define QORMQUERYPARAMETER_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qmetatype.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+class QDebug;
+
+// Placeholder for a filter value that is bound when a QOrmPreparedQuery is executed
+class Q_ORM_EXPORT QOrmQueryParameter
+{
+public:
+    QOrmQueryParameter() = default;
+    explicit QOrmQueryParameter(QString name);
+
+    Q_REQUIRED_RESULT
+    QString name() const;
+
+private:
+    QString m_name;
+};
+
+extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmQueryParameter& parameter);
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QOrmQueryParameter)
+
+#endif // QORMQUERYPARAMETER_H
@@ -29,6 +29,8 @@
 #include <QtCore/qvariant.h>
 #include <QtCore/qvector.h>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 class QOrmError;
@@ -50,6 +52,7 @@ public:
         : m_error{other.error()}
         , m_result{convertVector<U, T>(other.toVector())}
         , m_lastInsertedId{other.lastInsertedId()}
+        , m_owner{other.owner()}
     {
     }
 
@@ -76,6 +79,13 @@ public:
     {
     }
 
+    // Result of detached entity instances that are children of the owner
+    explicit QOrmQueryResult(const QVector<T*>& result, std::shared_ptr<QObject> owner)
+        : QOrmQueryResult<T>{result}
+    {
+        m_owner = std::move(owner);
+    }
+
     QOrmQueryResult& operator=(const QOrmQueryResult&) = delete;
     QOrmQueryResult& operator=(QOrmQueryResult&&) = default;
 
@@ -83,6 +93,12 @@ public:
     const QOrmError& error() const { return m_error; }
     Q_REQUIRED_RESULT
     const QVariant& lastInsertedId() const { return m_lastInsertedId; }
+
+    // Parent of the detached entity instances read with QOrm::QueryFlags::NoTracking. It deletes
+    // them when the last result sharing it is destroyed: reparent an instance to keep it.
+    Q_REQUIRED_RESULT
+    const std::shared_ptr<QObject>& owner() const { return m_owner; }
+
     Q_REQUIRED_RESULT
     const QVector<Projection*>& toVector() const
     {
@@ -143,6 +159,7 @@ private:
     QOrmError m_error;
     QVector<Projection*> m_result;
     QVariant m_lastInsertedId;
+    std::shared_ptr<QObject> m_owner;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qormrowset.h"
+
+#include <QMetaObject>
+#include <QMetaProperty>
+
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmRowSetData : public QSharedData
+{
+    friend class QOrmRowSet;
+
+    QOrmError m_error{QOrm::ErrorType::None, {}};
+    QStringList m_columnNames;
+    QVector<QVector<QVariant>> m_columns;
+};
+
+QOrmRowSet::QOrmRowSet()
+    : d{new QOrmRowSetData}
+{
+}
+
+QOrmRowSet::QOrmRowSet(const QStringList& columnNames)
+    : QOrmRowSet{}
+{
+    d->m_columnNames = columnNames;
+    d->m_columns.resize(columnNames.size());
+}
+
+QOrmRowSet::QOrmRowSet(const QOrmError& error)
+    : QOrmRowSet{}
+{
+    d->m_error = error;
+}
+
+QOrmRowSet::QOrmRowSet(const QOrmRowSet&) = default;
+
+QOrmRowSet::QOrmRowSet(QOrmRowSet&&) = default;
+
+QOrmRowSet::~QOrmRowSet() = default;
+
+QOrmRowSet& QOrmRowSet::operator=(const QOrmRowSet&) = default;
+
+QOrmRowSet& QOrmRowSet::operator=(QOrmRowSet&&) = default;
+
+const QOrmError& QOrmRowSet::error() const
+{
+    return d->m_error;
+}
+
+const QStringList& QOrmRowSet::columnNames() const
+{
+    return d->m_columnNames;
+}
+
+int QOrmRowSet::columnIndex(const QString& columnName) const
+{
+    return d->m_columnNames.indexOf(columnName);
+}
+
+int QOrmRowSet::columnCount() const
+{
+    return d->m_columns.size();
+}
+
+int QOrmRowSet::rowCount() const
+{
+    return d->m_columns.isEmpty() ? 0 : d->m_columns.front().size();
+}
+
+const QVector<QVariant>& QOrmRowSet::column(int columnIndex) const
+{
+    if (d->m_error.type() != QOrm::ErrorType::None)
+    {
+        qFatal("qtorm: QOrmRowSet::column() has been called but the row set contains an error: %s",
+               qPrintable(d->m_error.text()));
+    }
+
+    Q_ASSERT(columnIndex >= 0 && columnIndex < d->m_columns.size());
+
+    return d->m_columns.at(columnIndex);
+}
+
+QVariant QOrmRowSet::value(int row, int columnIndex) const
+{
+    return column(columnIndex).at(row);
+}
+
+// The gadgets are rowCount() values of qMetaObject's type laid out gadgetSize bytes apart
+void QOrmRowSet::writeToGadgets(const QMetaObject& qMetaObject,
+                                void* gadgets,
+                                size_t gadgetSize) const
+{
+    if (d->m_error.type() != QOrm::ErrorType::None)
+    {
+        qFatal("qtorm: QOrmRowSet::toValues() has been called but the row set contains an error: "
+               "%s",
+               qPrintable(d->m_error.text()));
+    }
+
+    std::vector<QMetaProperty> properties;
+    properties.reserve(static_cast<size_t>(d->m_columnNames.size()));
+
+    for (const QString& columnName : qAsConst(d->m_columnNames))
+    {
+        int index = qMetaObject.indexOfProperty(columnName.toUtf8().constData());
+
+        if (index == -1)
+        {
+            qFatal("qtorm: %s has no property %s",
+                   qMetaObject.className(),
+                   qPrintable(columnName));
+        }
+
+        properties.push_back(qMetaObject.property(index));
+    }
+
+    auto* gadget = static_cast<char*>(gadgets);
+
+    for (int row = 0; row < rowCount(); ++row, gadget += gadgetSize)
+    {
+        for (size_t column = 0; column < properties.size(); ++column)
+        {
+            properties[column].writeOnGadget(gadget,
+                                             d->m_columns[static_cast<int>(column)].at(row));
+        }
+    }
+}
+
+void QOrmRowSet::reserve(int rowCount)
+{
+    for (QVector<QVariant>& values : d->m_columns)
+        values.reserve(rowCount);
+}
+
+void QOrmRowSet::appendRow(const QVector<QVariant>& values)
+{
+    Q_ASSERT(values.size() == d->m_columns.size());
+
+    for (int i = 0; i < values.size(); ++i)
+        d->m_columns[i].push_back(values[i]);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMROWSET_H
+#define QORMROWSET_H
+
+#include <QtOrm/qormerror.h>
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+class QMetaObject;
+class QOrmRowSetData;
+
+// Values of the selected columns of a read query, stored column by column without an entity
+// instance per row. See QOrmQueryBuilder::selectColumns().
+class Q_ORM_EXPORT QOrmRowSet
+{
+public:
+    QOrmRowSet();
+    explicit QOrmRowSet(const QStringList& columnNames);
+    explicit QOrmRowSet(const QOrmError& error);
+    QOrmRowSet(const QOrmRowSet&);
+    QOrmRowSet(QOrmRowSet&&);
+    ~QOrmRowSet();
+
+    QOrmRowSet& operator=(const QOrmRowSet&);
+    QOrmRowSet& operator=(QOrmRowSet&&);
+
+    Q_REQUIRED_RESULT
+    const QOrmError& error() const;
+
+    Q_REQUIRED_RESULT
+    const QStringList& columnNames() const;
+
+    // Index of the column of a class property, or -1
+    Q_REQUIRED_RESULT
+    int columnIndex(const QString& columnName) const;
+
+    Q_REQUIRED_RESULT
+    int columnCount() const;
+
+    Q_REQUIRED_RESULT
+    int rowCount() const;
+
+    Q_REQUIRED_RESULT
+    const QVector<QVariant>& column(int columnIndex) const;
+
+    Q_REQUIRED_RESULT
+    QVariant value(int row, int columnIndex) const;
+
+    // The values of a column converted to T
+    template<typename T>
+    Q_REQUIRED_RESULT QVector<T> columnValues(int columnIndex) const
+    {
+        const QVector<QVariant>& values = column(columnIndex);
+
+        QVector<T> result;
+        result.reserve(values.size());
+
+        for (const QVariant& value : values)
+            result.push_back(qvariant_cast<T>(value));
+
+        return result;
+    }
+
+    // The rows as tuples of the column values converted to Ts, one type per column
+    template<typename... Ts>
+    Q_REQUIRED_RESULT std::vector<std::tuple<Ts...>> toTuples() const
+    {
+        Q_ASSERT(static_cast<int>(sizeof...(Ts)) == columnCount());
+
+        std::vector<std::tuple<Ts...>> result;
+        result.reserve(static_cast<size_t>(rowCount()));
+
+        for (int row = 0; row < rowCount(); ++row)
+            result.push_back(tupleAt<Ts...>(row, std::index_sequence_for<Ts...>{}));
+
+        return result;
+    }
+
+    // The rows as values of a Q_GADGET, each column written to the property of the same name
+    template<typename T>
+    Q_REQUIRED_RESULT QVector<T> toValues() const
+    {
+        QVector<T> result(rowCount());
+        writeToGadgets(T::staticMetaObject, result.data(), sizeof(T));
+
+        return result;
+    }
+
+    void reserve(int rowCount);
+    // Appends a row; there must be a value per column
+    void appendRow(const QVector<QVariant>& values);
+
+private:
+    void writeToGadgets(const QMetaObject& qMetaObject, void* gadgets, size_t gadgetSize) const;
+
+    template<typename... Ts, size_t... Is>
+    std::tuple<Ts...> tupleAt(int row, std::index_sequence<Is...>) const
+    {
+        return std::tuple<Ts...>{qvariant_cast<Ts>(column(static_cast<int>(Is)).at(row))...};
+    }
+
+    QSharedDataPointer<QOrmRowSetData> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMROWSET_H
@@ -21,24 +21,42 @@
 #include "qormsession.h"
 
 #include "qormabstractprovider.h"
+#include "qormcrossreferencevalidator_p.h"
 #include "qormentityinstancecache.h"
 #include "qormerror.h"
 #include "qormglobal_p.h"
 #include "qormmetadatacache.h"
 #include "qormorder.h"
+#include "qormpropertymapping.h"
 #include "qormquery.h"
+#include "qormquerycache.h"
 #include "qormrelation.h"
 #include "qormsessionconfiguration.h"
+#include "qormsessionstatistics.h"
+#include "qormtracer.h"
 #include "qormtransactiontoken.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QMetaProperty>
 #include <QScopeGuard>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 class QOrmSessionPrivate
 {
-    using TrackedEntityInstance = std::pair<QObject*, QOrm::Operation>;
+    // Entity instance touched in the current transaction with its property values as they were
+    // before the transaction has touched it
+    struct TrackedEntityInstance
+    {
+        QObject* instance;
+        QOrmMetadata entity;
+        QVector<QVariant> snapshot;
+        bool isCreated;
+        bool isRemoved;
+    };
 
     Q_DECLARE_PUBLIC(QOrmSession)
     QOrmSession* q_ptr{nullptr};
@@ -46,15 +64,28 @@ class QOrmSessionPrivate
     QOrmEntityInstanceCache m_entityInstanceCache;
     QOrmError m_lastError{QOrm::ErrorType::None, {}};
     QOrmMetadataCache m_metadataCache;
+    QOrmQueryCache* m_queryCache{nullptr};
+    QOrmSessionStatistics m_statistics;
     QSet<const QObject*> m_mergingInstances;
+    QOrmCrossReferenceValidator m_crossReferenceValidator;
     int m_transactionCounter{0};
+    // tables written in the current transaction, invalidated again in the query cache when it
+    // ends; the query cache is bypassed until then
+    QSet<QString> m_uncommittedTableNames;
     std::vector<TrackedEntityInstance> m_trackedInstances;
+    QHash<const QObject*, size_t> m_trackedInstanceIndexes;
 
     explicit QOrmSessionPrivate(QOrmSessionConfiguration sessionConfiguration, QOrmSession* parent);
     ~QOrmSessionPrivate();
 
     void ensureProviderConnected();
 
+    Q_REQUIRED_RESULT
+    bool isCrossReferenceValidationEnabled() const;
+
+    Q_REQUIRED_RESULT
+    bool isUpsert(const QOrmMetadata& entity, const QObject* instance) const;
+
     bool needsMerge(const QObject* instance)
     {
         return instance != nullptr &&
@@ -63,9 +94,32 @@ class QOrmSessionPrivate
                !m_mergingInstances.contains(instance);
     }
 
+    // New or modified entity instances of one entity written together by mergeGraph()
+    struct MergeGroup
+    {
+        QOrmMetadata entity;
+        QVector<QObject*> created;
+        QVector<QObject*> updated;
+        QVector<QObject*> upserted;
+    };
+
+    Q_REQUIRED_RESULT
+    QVector<QObject*> collectInstancesToMerge(QObject* entityInstance);
+    Q_REQUIRED_RESULT
+    static bool sortByDependencies(std::vector<MergeGroup>& groups);
+    Q_REQUIRED_RESULT
+    bool mergeGroup(const MergeGroup& group);
+
+    size_t trackInstance(QObject* instance, const QOrmMetadata& entity);
     void commitTrackedInstances();
     void rollbackTrackedInstances();
 
+    std::optional<QVector<QObject*>> cachedQueryResult(const QOrmQuery& query);
+    std::optional<QVector<QObject*>> inMemoryQueryResult(const QOrmQuery& query) const;
+    QOrmQueryResult<QObject> readDetached(const QOrmQuery& query);
+    void invalidateQueryCache(const QOrmMetadata& entity);
+    void invalidateUncommittedTables();
+
     void clearLastError();
     void setLastError(QOrmError lastError);
 };
@@ -75,9 +129,15 @@ QOrmSessionPrivate::QOrmSessionPrivate(QOrmSessionConfiguration sessionConfigura
     : q_ptr{parent}
     , m_sessionConfiguration{std::move(sessionConfiguration)}
 {
+    m_sessionConfiguration.provider()->setStatistics(&m_statistics);
 }
 
-QOrmSessionPrivate::~QOrmSessionPrivate() = default;
+QOrmSessionPrivate::~QOrmSessionPrivate()
+{
+    // the provider can outlive the session if its configuration is shared
+    if (m_sessionConfiguration.provider()->statistics() == &m_statistics)
+        m_sessionConfiguration.provider()->setStatistics(nullptr);
+}
 
 void QOrmSessionPrivate::ensureProviderConnected()
 {
@@ -85,42 +145,426 @@ void QOrmSessionPrivate::ensureProviderConnected()
         m_sessionConfiguration.provider()->connectToBackend();
 }
 
+bool QOrmSessionPrivate::isCrossReferenceValidationEnabled() const
+{
+    switch (m_sessionConfiguration.crossReferenceValidation())
+    {
+        case QOrm::CrossReferenceValidation::Always:
+            return true;
+
+        case QOrm::CrossReferenceValidation::DebugOnly:
+#ifdef QT_NO_DEBUG
+            return false;
+#else
+            return true;
+#endif
+
+        case QOrm::CrossReferenceValidation::Off:
+            return false;
+    }
+
+    Q_ORM_UNEXPECTED_STATE;
+}
+
+// In the upsert merge mode, an instance unknown to the session is upserted if it has its object
+// ID set: it may already exist in the backend
+bool QOrmSessionPrivate::isUpsert(const QOrmMetadata& entity, const QObject* instance) const
+{
+    if (m_sessionConfiguration.mergeMode() != QOrm::MergeMode::Upsert)
+        return false;
+
+    const QOrmPropertyMapping* objectIdMapping = entity.objectIdMapping();
+
+    if (objectIdMapping == nullptr)
+        return false;
+
+    if (!objectIdMapping->isAutogenerated())
+        return true;
+
+    // an autogenerated object ID of zero is yet to be generated
+    QVariant objectId = QOrmPrivate::objectIdPropertyValue(instance, entity);
+
+    return !objectId.isNull() && objectId.toLongLong() != 0;
+}
+
+// Returns the instances that need to be merged among the ones reachable from the entity instance
+// through references and lists of references, in the order they were visited
+QVector<QObject*> QOrmSessionPrivate::collectInstancesToMerge(QObject* entityInstance)
+{
+    QVector<QObject*> result;
+    QVector<QObject*> pending{entityInstance};
+    QSet<const QObject*> visited{entityInstance};
+
+    while (!pending.isEmpty())
+    {
+        QObject* instance = pending.takeLast();
+
+        if (needsMerge(instance))
+            result.push_back(instance);
+
+        const QOrmMetadata& entity = m_metadataCache[*instance->metaObject()];
+
+        for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+        {
+            if (!mapping.isReference())
+                continue;
+
+            QVariant value = QOrmPrivate::propertyValue(instance, mapping);
+            QObject* referencedInstance = value.value<QObject*>();
+
+            const QVector<QObject*> referencedInstances =
+                referencedInstance != nullptr ? QVector<QObject*>{referencedInstance}
+                                              : value.value<QVector<QObject*>>();
+
+            // pushed in reverse to visit the instances of a list in their order
+            for (auto it = referencedInstances.crbegin(); it != referencedInstances.crend(); ++it)
+            {
+                if (*it == nullptr || visited.contains(*it))
+                    continue;
+
+                visited.insert(*it);
+                pending.push_back(*it);
+            }
+        }
+    }
+
+    return result;
+}
+
+// Orders the groups so that the entities referenced by an entity are written before it. Returns
+// false and leaves the groups unspecified if the entities reference each other or themselves.
+bool QOrmSessionPrivate::sortByDependencies(std::vector<MergeGroup>& groups)
+{
+    std::vector<MergeGroup> sorted;
+    sorted.reserve(groups.size());
+
+    auto referencesPendingGroup = [&groups](const MergeGroup& group) {
+        for (const QOrmPropertyMapping& mapping : group.entity.propertyMappings())
+        {
+            if (!mapping.isReference() || mapping.isTransient())
+                continue;
+
+            for (const MergeGroup& pendingGroup : groups)
+            {
+                if (pendingGroup.entity.className() == mapping.referencedEntity()->className())
+                    return true;
+            }
+        }
+
+        return false;
+    };
+
+    while (!groups.empty())
+    {
+        auto it = std::find_if_not(std::begin(groups), std::end(groups), referencesPendingGroup);
+
+        if (it == std::end(groups))
+            return false;
+
+        sorted.push_back(std::move(*it));
+        groups.erase(it);
+    }
+
+    groups = std::move(sorted);
+
+    return true;
+}
+
+bool QOrmSessionPrivate::mergeGroup(const MergeGroup& group)
+{
+    QOrmAbstractProvider* provider = m_sessionConfiguration.provider();
+
+    if (!group.created.isEmpty())
+    {
+        QOrmQueryResult<QObject> result = provider->executeBatch(QOrm::Operation::Create,
+                                                                 group.entity,
+                                                                 group.created,
+                                                                 m_entityInstanceCache);
+
+        setLastError(result.error());
+
+        if (m_lastError.type() != QOrm::ErrorType::None)
+            return false;
+
+        const QOrmPropertyMapping* objectIdMapping = group.entity.objectIdMapping();
+        const QVariantList objectIds = result.lastInsertedId().toList();
+
+        Q_ASSERT(objectIds.size() == group.created.size());
+
+        for (int i = 0; i < group.created.size(); ++i)
+        {
+            QObject* instance = group.created[i];
+
+            if (objectIdMapping != nullptr && objectIdMapping->isAutogenerated())
+            {
+                if (!QOrmPrivate::setPropertyValue(instance,
+                                                   objectIdMapping->classPropertyName(),
+                                                   objectIds[i]))
+                {
+                    Q_ORM_UNEXPECTED_STATE;
+                }
+            }
+
+            m_entityInstanceCache.insert(group.entity, instance);
+            m_entityInstanceCache.finalize(group.entity, instance);
+        }
+    }
+
+    if (!group.updated.isEmpty())
+    {
+        QOrmQueryResult<QObject> result = provider->executeBatch(QOrm::Operation::Update,
+                                                                 group.entity,
+                                                                 group.updated,
+                                                                 m_entityInstanceCache);
+
+        setLastError(result.error());
+
+        if (m_lastError.type() != QOrm::ErrorType::None)
+            return false;
+
+        for (QObject* instance : group.updated)
+            m_entityInstanceCache.markUnmodified(instance);
+    }
+
+    if (!group.upserted.isEmpty())
+    {
+        QOrmQueryResult<QObject> result = provider->executeBatch(QOrm::Operation::Merge,
+                                                                 group.entity,
+                                                                 group.upserted,
+                                                                 m_entityInstanceCache);
+
+        setLastError(result.error());
+
+        if (m_lastError.type() != QOrm::ErrorType::None)
+            return false;
+
+        for (QObject* instance : group.upserted)
+        {
+            m_entityInstanceCache.insert(group.entity, instance);
+            m_entityInstanceCache.finalize(group.entity, instance);
+        }
+    }
+
+    invalidateQueryCache(group.entity);
+
+    return true;
+}
+
+size_t QOrmSessionPrivate::trackInstance(QObject* instance, const QOrmMetadata& entity)
+{
+    auto it = m_trackedInstanceIndexes.find(instance);
+
+    if (it != std::end(m_trackedInstanceIndexes))
+        return it.value();
+
+    bool isCreated = !m_entityInstanceCache.contains(instance);
+
+    // For cached instances, take the state as it was persisted: the instance could have been
+    // modified in memory before it was merged.
+    QVector<QVariant> snapshot =
+        isCreated ? QVector<QVariant>{} : m_entityInstanceCache.snapshot(instance);
+
+    if (snapshot.isEmpty())
+        snapshot = QOrmPrivate::entityInstanceSnapshot(entity, instance);
+
+    m_trackedInstances.push_back(
+        TrackedEntityInstance{instance, entity, std::move(snapshot), isCreated, false});
+    m_trackedInstanceIndexes.insert(instance, m_trackedInstances.size() - 1);
+
+    return m_trackedInstances.size() - 1;
+}
+
 void QOrmSessionPrivate::commitTrackedInstances()
 {
-    for (auto& [instance, operation] : m_trackedInstances)
+    for (const TrackedEntityInstance& tracked : m_trackedInstances)
     {
-        if (operation == QOrm::Operation::Delete)
-            instance->deleteLater();
+        if (tracked.isRemoved)
+            tracked.instance->deleteLater();
     }
 
     m_trackedInstances.clear();
+    m_trackedInstanceIndexes.clear();
 }
 
 void QOrmSessionPrivate::rollbackTrackedInstances()
 {
-    for (auto& [instance, operation] : m_trackedInstances)
+    for (auto it = m_trackedInstances.rbegin(); it != m_trackedInstances.rend(); ++it)
     {
-        Q_UNUSED(operation)
-
-        QOrmMetadata relation = m_metadataCache.get(*instance->metaObject());
-        QOrmMetadata projection = relation;
-        QOrmFilter filter{*relation.objectIdMapping() ==
-                          QOrmPrivate::objectIdPropertyValue(instance, relation)};
+        invalidateQueryCache(it->entity);
 
-        QOrmQuery query{QOrm::Operation::Read,
-                        QOrmRelation{relation},
-                        projection,
-                        filter,
-                        {},
-                        QOrm::QueryFlags::OverwriteCachedInstances};
-        QOrmQueryResult result =
-            m_sessionConfiguration.provider()->execute(query, m_entityInstanceCache);
+        if (it->isCreated)
+        {
+            // the instance does not exist in the backend anymore; evict it and restore its
+            // object ID as it was before the creation
+            m_entityInstanceCache.take(it->instance);
+            QOrmPrivate::restoreEntityInstanceSnapshot(it->entity, it->instance, it->snapshot);
+        }
+        else
+        {
+            if (it->isRemoved)
+            {
+                m_entityInstanceCache.insert(it->entity, it->instance);
+                m_entityInstanceCache.finalize(it->entity, it->instance);
+            }
 
-        if (result.error().type() != QOrm::ErrorType::None)
-            qFatal("QtOrm: Inconsistent state: unable to rollback tracked instances.");
+            QOrmPrivate::restoreEntityInstanceSnapshot(it->entity, it->instance, it->snapshot);
+            m_entityInstanceCache.markUnmodified(it->instance);
+        }
     }
 
     m_trackedInstances.clear();
+    m_trackedInstanceIndexes.clear();
+}
+
+std::optional<QVector<QObject*>> QOrmSessionPrivate::cachedQueryResult(const QOrmQuery& query)
+{
+    std::optional<QVector<QVariant>> objectIds = m_queryCache->find(query);
+
+    m_statistics.recordQueryCacheLookup(objectIds.has_value());
+
+    if (!objectIds.has_value())
+        return std::nullopt;
+
+    const QOrmMetadata& projection = *query.projection();
+    QVector<QObject*> result;
+    result.reserve(objectIds->size());
+    QVector<QVariant> missingObjectIds;
+
+    for (const QVariant& objectId : qAsConst(*objectIds))
+    {
+        QObject* instance = m_entityInstanceCache.get(projection, objectId);
+
+        // Let the provider report instances with unsaved changes
+        if (instance != nullptr && m_entityInstanceCache.isModified(instance))
+            return std::nullopt;
+
+        if (instance == nullptr)
+            missingObjectIds.push_back(objectId);
+
+        result.push_back(instance);
+    }
+
+    // The IDs can come from another session: read the instances not yet known to this session
+    if (!missingObjectIds.isEmpty())
+    {
+        QOrmFilterTerminalPredicate filter{*projection.objectIdMapping(),
+                                           QOrm::Comparison::In,
+                                           missingObjectIds.toList()};
+
+        QOrmQuery missingInstancesQuery{QOrm::Operation::Read,
+                                        QOrmRelation{projection},
+                                        projection,
+                                        QOrmFilter{filter},
+                                        {},
+                                        query.flags()};
+
+        QOrmQueryResult<QObject> missingInstances =
+            m_sessionConfiguration.provider()->execute(missingInstancesQuery,
+                                                       m_entityInstanceCache);
+
+        if (missingInstances.error().type() != QOrm::ErrorType::None)
+            return std::nullopt;
+
+        for (int i = 0; i < result.size(); ++i)
+        {
+            if (result[i] == nullptr)
+                result[i] = m_entityInstanceCache.get(projection, objectIds->at(i));
+
+            // deleted in the meantime by a session not sharing this query cache
+            if (result[i] == nullptr)
+                return std::nullopt;
+        }
+    }
+
+    return std::make_optional(result);
+}
+
+std::optional<QVector<QObject*>> QOrmSessionPrivate::inMemoryQueryResult(
+    const QOrmQuery& query) const
+{
+    if (query.operation() != QOrm::Operation::Read ||
+        query.relation().type() != QOrm::RelationType::Mapping ||
+        !query.projection().has_value() || query.projection()->objectIdMapping() == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    if (query.filter().has_value() && query.filter()->type() != QOrm::FilterType::Expression)
+        return std::nullopt;
+
+    const QOrmMetadata& projection = *query.projection();
+
+    // PreferCache only answers from memory if no instance of the entity can be missing
+    if (!query.flags().testFlag(QOrm::QueryFlags::InMemory) &&
+        !(query.flags().testFlag(QOrm::QueryFlags::PreferCache) &&
+          m_entityInstanceCache.isFullyLoaded(projection)))
+    {
+        return std::nullopt;
+    }
+
+    QVector<QObject*> result;
+
+    for (QObject* instance : m_entityInstanceCache.instances(projection))
+    {
+        if (!query.filter().has_value() ||
+            QOrmPrivate::evaluateFilterExpression(*query.filter()->expression(), instance))
+        {
+            result.push_back(instance);
+        }
+    }
+
+    QOrmPrivate::sortEntityInstances(result, query.order(), projection.objectIdMapping());
+
+    int offset = qBound(0, query.offset().value_or(0), result.size());
+    int limit = query.limit().has_value() ? qBound(0, *query.limit(), result.size() - offset)
+                                          : result.size() - offset;
+
+    return std::make_optional(result.mid(offset, limit));
+}
+
+// Reads the entity instances with a scratch cache that only resolves the references within the
+// result. The instances are handed over to the result instead of the entity instance cache.
+QOrmQueryResult<QObject> QOrmSessionPrivate::readDetached(const QOrmQuery& query)
+{
+    ensureProviderConnected();
+
+    QOrmEntityInstanceCache scratchCache;
+    QOrmQueryResult<QObject> result =
+        m_sessionConfiguration.provider()->execute(query, scratchCache);
+
+    // on error, the instances read so far are deleted with the scratch cache
+    if (result.error().type() != QOrm::ErrorType::None)
+        return result;
+
+    auto owner = std::make_shared<QObject>();
+
+    for (QObject* instance : scratchCache.takeAll())
+        instance->setParent(owner.get());
+
+    return QOrmQueryResult<QObject>{result.toVector(), std::move(owner)};
+}
+
+void QOrmSessionPrivate::invalidateQueryCache(const QOrmMetadata& entity)
+{
+    if (m_queryCache == nullptr)
+        return;
+
+    m_queryCache->invalidate(entity.tableName());
+
+    // Until the transaction ends, other sessions may still read and cache the previous rows
+    if (m_transactionCounter > 0)
+        m_uncommittedTableNames.insert(entity.tableName());
+}
+
+void QOrmSessionPrivate::invalidateUncommittedTables()
+{
+    if (m_queryCache != nullptr)
+    {
+        for (const QString& tableName : qAsConst(m_uncommittedTableNames))
+            m_queryCache->invalidate(tableName);
+    }
+
+    m_uncommittedTableNames.clear();
 }
 
 void QOrmSessionPrivate::clearLastError()
@@ -151,20 +595,151 @@ QOrmSession::~QOrmSession()
 QOrmQueryResult<QObject> QOrmSession::execute(const QOrmQuery& query)
 {
     Q_D(QOrmSession);
+    Q_ORM_TRACE_SCOPE("session", "execute");
 
     d->clearLastError();
+
+    // Only the instances that pass the pushed down filter are hydrated and passed to the
+    // invokable filters
+    if (!query.invokableFilters().empty())
+    {
+        QOrmQueryResult<QObject> result = execute(QOrmPrivate::pushedDownQuery(query));
+
+        if (result.error().type() != QOrm::ErrorType::None)
+            return result;
+
+        QVector<QObject*> entityInstances = result.toVector();
+        QOrmPrivate::applyInvokableFilters(query, entityInstances);
+
+        return QOrmQueryResult<QObject>{entityInstances, result.owner()};
+    }
+
+    if (query.operation() == QOrm::Operation::Read &&
+        query.flags().testFlag(QOrm::QueryFlags::NoTracking))
+    {
+        QOrmQueryResult<QObject> result = d->readDetached(query);
+        d->setLastError(result.error());
+
+        return result;
+    }
+
+    if (std::optional<QVector<QObject*>> inMemoryResult = d->inMemoryQueryResult(query))
+        return QOrmQueryResult<QObject>{*inMemoryResult};
+
     d->ensureProviderConnected();
 
+    // Results read within a transaction that has written may not be committed yet
+    bool isCacheable = d->m_queryCache != nullptr && d->m_uncommittedTableNames.isEmpty() &&
+                       QOrmQueryCache::isCacheable(query);
+    quint64 queryCacheGeneration = 0;
+
+    if (isCacheable)
+    {
+        if (std::optional<QVector<QObject*>> cachedResult = d->cachedQueryResult(query))
+            return QOrmQueryResult<QObject>{*cachedResult};
+
+        queryCacheGeneration = d->m_queryCache->generation();
+    }
+
     QOrmQueryResult<QObject> providerResult =
         d->m_sessionConfiguration.provider()->execute(query, d->m_entityInstanceCache);
 
     d->setLastError(providerResult.error());
+
+    // A modification by query changes rows behind the back of both caches
+    if (d->m_lastError.type() == QOrm::ErrorType::None &&
+        query.operation() != QOrm::Operation::Read)
+    {
+        const QOrmRelation* relation = &query.relation();
+
+        while (relation->type() == QOrm::RelationType::Query)
+            relation = &relation->query()->relation();
+
+        d->m_entityInstanceCache.setFullyLoaded(*relation->mapping(), false);
+        d->invalidateQueryCache(*relation->mapping());
+    }
+
+    // An unrestricted read of an entity leaves all its instances in the entity instance cache
+    if (d->m_lastError.type() == QOrm::ErrorType::None &&
+        query.operation() == QOrm::Operation::Read &&
+        query.relation().type() == QOrm::RelationType::Mapping && query.projection().has_value() &&
+        !query.filter().has_value() && !query.limit().has_value() && !query.offset().has_value())
+    {
+        d->m_entityInstanceCache.setFullyLoaded(*query.projection(), true);
+    }
+
+    if (isCacheable && d->m_lastError.type() == QOrm::ErrorType::None)
+    {
+        QVector<QVariant> objectIds;
+        objectIds.reserve(providerResult.toVector().size());
+
+        for (const QObject* instance : providerResult.toVector())
+            objectIds.push_back(QOrmPrivate::objectIdPropertyValue(instance, *query.projection()));
+
+        d->m_queryCache->insert(query, objectIds, queryCacheGeneration);
+    }
+
     return providerResult;
 }
 
+std::shared_ptr<QOrmPreparedStatement> QOrmSession::prepare(const QOrmQuery& query)
+{
+    Q_D(QOrmSession);
+
+    d->ensureProviderConnected();
+
+    return d->m_sessionConfiguration.provider()->prepare(query);
+}
+
+QOrmQueryResult<QObject> QOrmSession::execute(QOrmPreparedStatement& statement,
+                                              const QVariantMap& parameterValues)
+{
+    Q_D(QOrmSession);
+    Q_ORM_TRACE_SCOPE("session", "execute");
+
+    d->clearLastError();
+    d->ensureProviderConnected();
+
+    QVariantMap values = parameterValues;
+
+    for (QVariant& value : values)
+    {
+        const QObject* entityInstance = value.value<QObject*>();
+
+        if (entityInstance != nullptr)
+        {
+            value = QOrmPrivate::objectIdPropertyValue(
+                entityInstance, d->m_metadataCache[*entityInstance->metaObject()]);
+        }
+    }
+
+    QOrmQueryResult<QObject> providerResult =
+        d->m_sessionConfiguration.provider()->execute(statement, values, d->m_entityInstanceCache);
+
+    d->setLastError(providerResult.error());
+
+    return providerResult;
+}
+
+QOrmRowSet QOrmSession::executeRowSet(const QOrmQuery& query,
+                                      const std::vector<QOrmPropertyMapping>& columns)
+{
+    Q_D(QOrmSession);
+    Q_ORM_TRACE_SCOPE("session", "executeRowSet");
+
+    d->clearLastError();
+    d->ensureProviderConnected();
+
+    QOrmRowSet rowSet = d->m_sessionConfiguration.provider()->executeRowSet(query, columns);
+    d->setLastError(rowSet.error());
+
+    return rowSet;
+}
+
 QOrmQueryBuilder<QObject> QOrmSession::from(const QOrmQuery& query)
 {
     Q_ASSERT(query.operation() == QOrm::Operation::Read);
+    Q_ASSERT(query.invokableFilters().empty());
 
     return QOrmQueryBuilder<QObject>{this, QOrmRelation{query}};
 }
@@ -179,6 +754,7 @@ QOrmQueryBuilder<QObject> QOrmSession::queryBuilderFor(const QMetaObject& relati
 bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObject)
 {
     Q_D(QOrmSession);
+    Q_ORM_TRACE_SCOPE_DETAIL("session", "merge", QString::fromUtf8(qMetaObject.className()));
 
     Q_ASSERT(entityInstance != nullptr);
 
@@ -192,15 +768,18 @@ bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObjec
 
     auto mergeFinalizer = qScopeGuard([d, entityInstance]() {
         d->m_mergingInstances.remove(entityInstance);
-        d->m_trackedInstances.push_back(std::make_pair(entityInstance, QOrm::Operation::Merge));
     });
 
     d->clearLastError();
     d->ensureProviderConnected();
 
+    QOrmMetadata entity = d->m_metadataCache[qMetaObject];
+
     QOrm::Operation operation = d->m_entityInstanceCache.contains(entityInstance)
                                     ? QOrm::Operation::Update
-                                    : QOrm::Operation::Create;
+                                    : d->isUpsert(entity, entityInstance)
+                                          ? QOrm::Operation::Merge
+                                          : QOrm::Operation::Create;
 
     if (operation == QOrm::Operation::Update &&
         !d->m_entityInstanceCache.isModified(entityInstance))
@@ -208,13 +787,14 @@ bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObjec
         return true;
     }
 
-    QOrmMetadata entity = d->m_metadataCache[qMetaObject];
-
-    if (auto result = QOrmPrivate::crossReferenceError(entity, entityInstance))
+    if (d->isCrossReferenceValidationEnabled())
     {
-        qFatal("QtOrm: %s", result->toUtf8().data());
+        if (auto result = d->m_crossReferenceValidator.validate(entity, entityInstance))
+            qFatal("QtOrm: %s", result->toUtf8().data());
     }
 
+    d->trackInstance(entityInstance, entity);
+
     // Merge modified referenced entity instances
     for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
     {
@@ -258,15 +838,161 @@ bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObjec
             d->m_entityInstanceCache.insert(d->m_metadataCache[qMetaObject], entityInstance);
             d->m_entityInstanceCache.finalize(d->m_metadataCache[qMetaObject], entityInstance);
         }
+        else if (operation == QOrm::Operation::Merge)
+        {
+            d->m_entityInstanceCache.insert(entity, entityInstance);
+            d->m_entityInstanceCache.finalize(entity, entityInstance);
+        }
         else
             d->m_entityInstanceCache.markUnmodified(entityInstance);
 
+        d->invalidateQueryCache(entity);
         token.commit();
     }
 
     return d->m_lastError.type() == QOrm::ErrorType::None;
 }
 
+bool QOrmSession::doMergeGraph(QObject* entityInstance, const QMetaObject& qMetaObject)
+{
+    Q_D(QOrmSession);
+    Q_ORM_TRACE_SCOPE_DETAIL("session", "mergeGraph", QString::fromUtf8(qMetaObject.className()));
+
+    Q_ASSERT(entityInstance != nullptr);
+
+    d->clearLastError();
+    d->ensureProviderConnected();
+
+    const QVector<QObject*> instances = d->collectInstancesToMerge(entityInstance);
+
+    if (instances.isEmpty())
+        return true;
+
+    auto token = declareTransaction(QOrm::TransactionPropagation::Require,
+                                    QOrm::TransactionAction::Rollback);
+
+    std::vector<QOrmSessionPrivate::MergeGroup> groups;
+    QHash<const QMetaObject*, size_t> groupIndexes;
+
+    for (QObject* instance : instances)
+    {
+        const QMetaObject* metaObject = instance->metaObject();
+        auto it = groupIndexes.find(metaObject);
+
+        if (it == std::end(groupIndexes))
+        {
+            it = groupIndexes.insert(metaObject, groups.size());
+            groups.push_back(
+                QOrmSessionPrivate::MergeGroup{d->m_metadataCache[*metaObject], {}, {}, {}});
+        }
+
+        QOrmSessionPrivate::MergeGroup& group = groups[it.value()];
+
+        if (d->m_entityInstanceCache.contains(instance))
+            group.updated.push_back(instance);
+        else if (d->isUpsert(group.entity, instance))
+            group.upserted.push_back(instance);
+        else
+            group.created.push_back(instance);
+    }
+
+    // Instances of entities referencing each other are merged one by one, referenced ones first
+    if (!QOrmSessionPrivate::sortByDependencies(groups))
+    {
+        for (QObject* instance : instances)
+        {
+            if (!doMerge(instance, *instance->metaObject()))
+                return false;
+        }
+
+        token.commit();
+        return true;
+    }
+
+    for (const QOrmSessionPrivate::MergeGroup& group : groups)
+    {
+        for (QObject* instance : group.created + group.updated + group.upserted)
+        {
+            if (d->isCrossReferenceValidationEnabled())
+            {
+                if (auto result = d->m_crossReferenceValidator.validate(group.entity, instance))
+                    qFatal("QtOrm: %s", result->toUtf8().data());
+            }
+
+            d->trackInstance(instance, group.entity);
+        }
+
+        if (!d->mergeGroup(group))
+            return false;
+    }
+
+    token.commit();
+
+    return true;
+}
+
+// The values are count gadgets of qMetaObject's type laid out valueSize bytes apart
+bool QOrmSession::doInsertValues(const QMetaObject& qMetaObject,
+                                 const void* values,
+                                 int count,
+                                 size_t valueSize)
+{
+    Q_D(QOrmSession);
+    Q_ORM_TRACE_SCOPE_DETAIL("session",
+                             "insertValues",
+                             QString::fromUtf8(qMetaObject.className()));
+
+    d->clearLastError();
+
+    const QOrmMetadata& entity = d->m_metadataCache[qMetaObject];
+    Q_ASSERT(entity.isGadget());
+
+    if (count == 0)
+        return true;
+
+    d->ensureProviderConnected();
+
+    // the columns of the INSERT statement of the entity
+    std::vector<QMetaProperty> properties;
+    QStringList columnNames;
+
+    for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+    {
+        if (mapping.isTransient() || mapping.isAutogenerated())
+            continue;
+
+        properties.push_back(mapping.qMetaProperty());
+        columnNames.push_back(mapping.classPropertyName());
+    }
+
+    QOrmRowSet rowSet{columnNames};
+    rowSet.reserve(count);
+
+    QVector<QVariant> row(columnNames.size());
+    const auto* value = static_cast<const char*>(values);
+
+    for (int i = 0; i < count; ++i, value += valueSize)
+    {
+        for (int column = 0; column < row.size(); ++column)
+            row[column] = properties[static_cast<size_t>(column)].readOnGadget(value);
+
+        rowSet.appendRow(row);
+    }
+
+    auto token = declareTransaction(QOrm::TransactionPropagation::Require,
+                                    QOrm::TransactionAction::Rollback);
+
+    d->setLastError(d->m_sessionConfiguration.provider()->insertRowSet(entity, rowSet));
+
+    if (d->m_lastError.type() != QOrm::ErrorType::None)
+        return false;
+
+    token.commit();
+    d->invalidateQueryCache(entity);
+
+    return true;
+}
+
 bool QOrmSession::doRemove(QObject* entityInstance, const QMetaObject& qMetaObject)
 {
     Q_D(QOrmSession);
@@ -274,6 +1000,13 @@ bool QOrmSession::doRemove(QObject* entityInstance, const QMetaObject& qMetaObje
     d->clearLastError();
     d->ensureProviderConnected();
 
+    std::optional<size_t> trackedIndex;
+
+    // Within a transaction, keep the instance alive until commit so it can be restored on
+    // rollback
+    if (isTransactionActive())
+        trackedIndex = d->trackInstance(entityInstance, d->m_metadataCache[qMetaObject]);
+
     QOrmQueryResult result =
         d->m_sessionConfiguration.provider()->execute(queryBuilderFor(qMetaObject)
                                                           .instance(qMetaObject, entityInstance)
@@ -284,7 +1017,17 @@ bool QOrmSession::doRemove(QObject* entityInstance, const QMetaObject& qMetaObje
 
     if (d->m_lastError.type() == QOrm::ErrorType::None)
     {
-        delete d->m_entityInstanceCache.take(entityInstance);
+        if (trackedIndex.has_value())
+        {
+            d->m_entityInstanceCache.take(entityInstance);
+            d->m_trackedInstances[*trackedIndex].isRemoved = true;
+        }
+        else
+        {
+            delete d->m_entityInstanceCache.take(entityInstance);
+        }
+
+        d->invalidateQueryCache(d->m_metadataCache[qMetaObject]);
     }
 
     return d->m_lastError.type() == QOrm::ErrorType::None;
@@ -341,9 +1084,40 @@ QOrmMetadataCache* QOrmSession::metadataCache()
     return &d->m_metadataCache;
 }
 
+QOrmEntityInstanceCache* QOrmSession::entityInstanceCache()
+{
+    Q_D(QOrmSession);
+    return &d->m_entityInstanceCache;
+}
+
+QOrmQueryCache* QOrmSession::queryCache() const
+{
+    Q_D(const QOrmSession);
+    return d->m_queryCache;
+}
+
+void QOrmSession::setQueryCache(QOrmQueryCache* queryCache)
+{
+    Q_D(QOrmSession);
+    d->m_queryCache = queryCache;
+}
+
+const QOrmSessionStatistics& QOrmSession::statistics() const
+{
+    Q_D(const QOrmSession);
+    return d->m_statistics;
+}
+
+void QOrmSession::resetStatistics()
+{
+    Q_D(QOrmSession);
+    d->m_statistics.reset();
+}
+
 bool QOrmSession::beginTransaction()
 {
     Q_D(QOrmSession);
+    Q_ORM_TRACE_SCOPE("session", "beginTransaction");
 
     d->setLastError({QOrm::ErrorType::None, {}});
 
@@ -375,6 +1149,7 @@ bool QOrmSession::beginTransaction()
 bool QOrmSession::commitTransaction()
 {
     Q_D(QOrmSession);
+    Q_ORM_TRACE_SCOPE("session", "commitTransaction");
 
     d->setLastError(QOrmError{QOrm::ErrorType::None, {}});
 
@@ -388,12 +1163,18 @@ bool QOrmSession::commitTransaction()
             qCDebug(qtorm) << "Committing transaction";
 
         d->ensureProviderConnected();
+
+        QElapsedTimer timer;
+        timer.start();
+
         d->setLastError(d->m_sessionConfiguration.provider()->commitTransaction());
+        d->m_statistics.recordCommit(timer.nsecsElapsed());
 
         if (d->m_lastError.type() == QOrm::ErrorType::None)
         {
             d->commitTrackedInstances();
             d->m_transactionCounter = 0;
+            d->invalidateUncommittedTables();
         }
         else if (d->m_sessionConfiguration.isVerbose())
         {
@@ -411,6 +1192,7 @@ bool QOrmSession::commitTransaction()
 bool QOrmSession::rollbackTransaction()
 {
     Q_D(QOrmSession);
+    Q_ORM_TRACE_SCOPE("session", "rollbackTransaction");
 
     d->setLastError(QOrmError{QOrm::ErrorType::None, {}});
 
@@ -430,6 +1212,7 @@ bool QOrmSession::rollbackTransaction()
         {
             d->rollbackTrackedInstances();
             d->m_transactionCounter = 0;
+            d->invalidateUncommittedTables();
         }
         else if (d->m_sessionConfiguration.isVerbose())
         {
@@ -26,18 +26,27 @@
 #include <QtOrm/qormmetadata.h>
 #include <QtOrm/qormquerybuilder.h>
 #include <QtOrm/qormqueryresult.h>
+#include <QtOrm/qormrowset.h>
 #include <QtOrm/qormsessionconfiguration.h>
 #include <QtOrm/qormtransactiontoken.h>
 
 #include <QtCore/qobject.h>
 
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 
 class QOrmAbstractProvider;
 class QOrmEntityInstanceCache;
+class QOrmPreparedStatement;
+class QOrmPropertyMapping;
 class QOrmError;
 class QOrmQuery;
+class QOrmQueryCache;
 class QOrmSessionPrivate;
+class QOrmSessionStatistics;
 
 template<typename Projection>
 class QOrmQueryBuilder;
@@ -54,9 +63,24 @@ public:
     Q_REQUIRED_RESULT
     QOrmQueryResult<QObject> execute(const QOrmQuery& query);
 
+    // Reads only the given columns of the projection into a row set without creating or
+    // caching entity instances
+    Q_REQUIRED_RESULT
+    QOrmRowSet executeRowSet(const QOrmQuery& query,
+                             const std::vector<QOrmPropertyMapping>& columns);
+
     Q_REQUIRED_RESULT
     QOrmQueryBuilder<QObject> from(const QOrmQuery& query);
 
+    Q_REQUIRED_RESULT
+    std::shared_ptr<QOrmPreparedStatement> prepare(const QOrmQuery& query);
+
+    // Executes a statement prepared in this session. Entity instances bound as parameter values
+    // are replaced with their object IDs.
+    Q_REQUIRED_RESULT
+    QOrmQueryResult<QObject> execute(QOrmPreparedStatement& statement,
+                                     const QVariantMap& parameterValues);
+
     template<typename T>
     bool merge(T* entityInstance)
     {
@@ -96,6 +120,33 @@ public:
         return true;
     }
 
+    // Merges the entity instance together with the new and modified instances reachable through
+    // its references and lists of references. The instances are written in a single transaction
+    // with batched statements per entity, referenced entities first.
+    template<typename T>
+    bool mergeGraph(T* entityInstance)
+    {
+        return doMergeGraph(entityInstance, T::staticMetaObject);
+    }
+
+    // Inserts count values of a Q_GADGET entity with multi-row statements in a single
+    // transaction. Autogenerated object IDs are not written back to the values.
+    template<typename T>
+    bool insertValues(const T* values, int count)
+    {
+        static_assert(!std::is_convertible_v<T*, QObject*>,
+                      "insertValues() requires a Q_GADGET entity, use merge() for QObject "
+                      "entities");
+
+        return doInsertValues(T::staticMetaObject, values, count, sizeof(T));
+    }
+
+    template<typename T>
+    bool insertValues(const QVector<T>& values)
+    {
+        return insertValues(values.constData(), values.size());
+    }
+
     template<typename T>
     bool remove(T* entityInstance)
     {
@@ -130,6 +181,16 @@ public:
     Q_REQUIRED_RESULT
     QOrmEntityInstanceCache* entityInstanceCache();
 
+    Q_REQUIRED_RESULT
+    QOrmQueryCache* queryCache() const;
+    void setQueryCache(QOrmQueryCache* queryCache);
+
+    // Counters and latencies of the statements executed since the session was created or the
+    // statistics were reset
+    Q_REQUIRED_RESULT
+    const QOrmSessionStatistics& statistics() const;
+    void resetStatistics();
+
     bool beginTransaction();
     bool commitTransaction();
     bool rollbackTransaction();
@@ -137,6 +198,11 @@ public:
 
 private:
     bool doMerge(QObject* entityInstance, const QMetaObject& qMetaObject);
+    bool doMergeGraph(QObject* entityInstance, const QMetaObject& qMetaObject);
+    bool doInsertValues(const QMetaObject& qMetaObject,
+                        const void* values,
+                        int count,
+                        size_t valueSize);
     bool doRemove(QObject* entityInstance, const QMetaObject& qMetaObject);
 
     QOrmQueryBuilder<QObject> queryBuilderFor(const QMetaObject& relationMetaObject);
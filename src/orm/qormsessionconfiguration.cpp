@@ -40,8 +40,12 @@ class QOrmSessionConfigurationData : public QSharedData
 
     QOrmSessionConfigurationData(QOrmAbstractProvider* provider, bool isVerbose);
 
-    std::unique_ptr<QOrmAbstractProvider> m_provider;
+    // shared between the copies of a configuration, also after one of them is modified
+    std::shared_ptr<QOrmAbstractProvider> m_provider;
     bool m_isVerbose{false};
+    QOrm::CrossReferenceValidation m_crossReferenceValidation{
+        QOrm::CrossReferenceValidation::Always};
+    QOrm::MergeMode m_mergeMode{QOrm::MergeMode::Default};
 };
 
 QOrmSessionConfigurationData::QOrmSessionConfigurationData(QOrmAbstractProvider* provider,
@@ -58,6 +62,10 @@ static QOrmSqliteConfiguration _build_json_sqlite_configuration(const QJsonObjec
 
     sqlConfiguration.setDatabaseName(object["databaseName"].toString());
     sqlConfiguration.setVerbose(object["verbose"].toBool(false));
+    sqlConfiguration.setSlowQueryThreshold(
+        object["slowQueryThreshold"].toInt(sqlConfiguration.slowQueryThreshold()));
+    sqlConfiguration.setLargeTableThreshold(
+        object["largeTableThreshold"].toInt(sqlConfiguration.largeTableThreshold()));
 
     QString schemaModeStr = object["schemaMode"].toString("validate");
 
@@ -126,6 +134,9 @@ QOrmSessionConfiguration QOrmSessionConfiguration::fromFile(const QString& fileP
 
             std::unique_ptr<QOrmAbstractProvider> provider;
             bool isVerbose = rootObject["verbose"].toBool(false);
+            QString crossReferenceValidationStr =
+                rootObject["crossReferenceValidation"].toString("always");
+            QString mergeModeStr = rootObject["mergeMode"].toString("default");
 
             if (rootObject["provider"].toString().compare("sqlite") == 0)
             {
@@ -134,7 +145,42 @@ QOrmSessionConfiguration QOrmSessionConfiguration::fromFile(const QString& fileP
                 provider = std::make_unique<QOrmSqliteProvider>(sqlConfiguration);
             }
 
-            return QOrmSessionConfiguration{provider.release(), isVerbose};
+            QOrmSessionConfiguration configuration{provider.release(), isVerbose};
+
+            if (crossReferenceValidationStr.compare("always", Qt::CaseInsensitive) == 0)
+            {
+                configuration.setCrossReferenceValidation(QOrm::CrossReferenceValidation::Always);
+            }
+            else if (crossReferenceValidationStr.compare("debugOnly", Qt::CaseInsensitive) == 0)
+            {
+                configuration.setCrossReferenceValidation(
+                    QOrm::CrossReferenceValidation::DebugOnly);
+            }
+            else if (crossReferenceValidationStr.compare("off", Qt::CaseInsensitive) == 0)
+            {
+                configuration.setCrossReferenceValidation(QOrm::CrossReferenceValidation::Off);
+            }
+            else
+            {
+                qCWarning(qtorm) << "Invalid crossReferenceValidation in session configuration. "
+                                    "Falling back to always";
+            }
+
+            if (mergeModeStr.compare("default", Qt::CaseInsensitive) == 0)
+            {
+                configuration.setMergeMode(QOrm::MergeMode::Default);
+            }
+            else if (mergeModeStr.compare("upsert", Qt::CaseInsensitive) == 0)
+            {
+                configuration.setMergeMode(QOrm::MergeMode::Upsert);
+            }
+            else
+            {
+                qCWarning(qtorm) << "Invalid mergeMode in session configuration. "
+                                    "Falling back to default";
+            }
+
+            return configuration;
         }
     }
 
@@ -167,4 +213,25 @@ bool QOrmSessionConfiguration::isVerbose() const
     return d->m_isVerbose;
 }
 
+QOrm::CrossReferenceValidation QOrmSessionConfiguration::crossReferenceValidation() const
+{
+    return d->m_crossReferenceValidation;
+}
+
+void QOrmSessionConfiguration::setCrossReferenceValidation(
+    QOrm::CrossReferenceValidation crossReferenceValidation)
+{
+    d->m_crossReferenceValidation = crossReferenceValidation;
+}
+
+QOrm::MergeMode QOrmSessionConfiguration::mergeMode() const
+{
+    return d->m_mergeMode;
+}
+
+void QOrmSessionConfiguration::setMergeMode(QOrm::MergeMode mergeMode)
+{
+    d->m_mergeMode = mergeMode;
+}
+
 QT_END_NAMESPACE
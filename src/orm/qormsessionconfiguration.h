@@ -54,6 +54,14 @@ public:
     Q_REQUIRED_RESULT
     bool isVerbose() const;
 
+    Q_REQUIRED_RESULT
+    QOrm::CrossReferenceValidation crossReferenceValidation() const;
+    void setCrossReferenceValidation(QOrm::CrossReferenceValidation crossReferenceValidation);
+
+    Q_REQUIRED_RESULT
+    QOrm::MergeMode mergeMode() const;
+    void setMergeMode(QOrm::MergeMode mergeMode);
+
 private:
     QSharedDataPointer<QOrmSessionConfigurationData> d;
 };
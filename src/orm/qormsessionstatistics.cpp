@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qormsessionstatistics.h"
+
+#include "qormmetadata.h"
+
+#include <QDebug>
+#include <QHash>
+
+#include <algorithm>
+#include <array>
+
+QT_BEGIN_NAMESPACE
+
+const QVector<qint64>& QOrmLatencyHistogram::bucketUpperBounds()
+{
+    static const QVector<qint64> bounds = {10'000,
+                                           50'000,
+                                           100'000,
+                                           500'000,
+                                           1'000'000,
+                                           5'000'000,
+                                           10'000'000,
+                                           50'000'000,
+                                           100'000'000,
+                                           500'000'000,
+                                           1'000'000'000};
+
+    return bounds;
+}
+
+void QOrmLatencyHistogram::record(qint64 nanoseconds)
+{
+    const QVector<qint64>& bounds = bucketUpperBounds();
+    auto it = std::lower_bound(std::cbegin(bounds), std::cend(bounds), nanoseconds);
+
+    ++m_bucketCounts[static_cast<int>(std::distance(std::cbegin(bounds), it))];
+    ++m_count;
+    m_totalNanoseconds += nanoseconds;
+    m_maxNanoseconds = std::max(m_maxNanoseconds, nanoseconds);
+}
+
+QOrmLatencyHistogram& QOrmLatencyHistogram::operator+=(const QOrmLatencyHistogram& other)
+{
+    for (int i = 0; i < m_bucketCounts.size(); ++i)
+        m_bucketCounts[i] += other.m_bucketCounts[i];
+
+    m_count += other.m_count;
+    m_totalNanoseconds += other.m_totalNanoseconds;
+    m_maxNanoseconds = std::max(m_maxNanoseconds, other.m_maxNanoseconds);
+
+    return *this;
+}
+
+qint64 QOrmLatencyHistogram::meanNanoseconds() const
+{
+    return m_count == 0 ? 0 : m_totalNanoseconds / static_cast<qint64>(m_count);
+}
+
+QOrmStatementStatistics& QOrmStatementStatistics::operator+=(const QOrmStatementStatistics& other)
+{
+    m_statementCount += other.m_statementCount;
+    m_rowCount += other.m_rowCount;
+    m_executionLatency += other.m_executionLatency;
+    m_hydrationLatency += other.m_hydrationLatency;
+
+    return *this;
+}
+
+class QOrmSessionStatisticsPrivate
+{
+    friend class QOrmSessionStatistics;
+
+    static constexpr int OperationCount = static_cast<int>(QOrm::Operation::Merge) + 1;
+
+    // statements per entity class name, indexed by operation
+    QHash<QString, std::array<QOrmStatementStatistics, OperationCount>> m_statements;
+    quint64 m_entityInstanceCacheHitCount{0};
+    quint64 m_entityInstanceCacheMissCount{0};
+    quint64 m_queryCacheHitCount{0};
+    quint64 m_queryCacheMissCount{0};
+    quint64 m_schemaSynchronizationCount{0};
+    QOrmLatencyHistogram m_commitLatency;
+};
+
+QOrmSessionStatistics::QOrmSessionStatistics()
+    : d{new QOrmSessionStatisticsPrivate}
+{
+}
+
+QOrmSessionStatistics::~QOrmSessionStatistics() = default;
+
+QOrmStatementStatistics QOrmSessionStatistics::statementStatistics(QOrm::Operation operation) const
+{
+    QOrmStatementStatistics statistics;
+
+    for (const auto& statements : qAsConst(d->m_statements))
+        statistics += statements[static_cast<size_t>(operation)];
+
+    return statistics;
+}
+
+QOrmStatementStatistics QOrmSessionStatistics::statementStatistics(QOrm::Operation operation,
+                                                                   const QString& className) const
+{
+    auto it = d->m_statements.find(className);
+
+    return it == std::cend(d->m_statements) ? QOrmStatementStatistics{}
+                                            : it.value()[static_cast<size_t>(operation)];
+}
+
+QStringList QOrmSessionStatistics::classNames() const
+{
+    return d->m_statements.keys();
+}
+
+quint64 QOrmSessionStatistics::entityInstanceCacheHitCount() const
+{
+    return d->m_entityInstanceCacheHitCount;
+}
+
+quint64 QOrmSessionStatistics::entityInstanceCacheMissCount() const
+{
+    return d->m_entityInstanceCacheMissCount;
+}
+
+quint64 QOrmSessionStatistics::queryCacheHitCount() const
+{
+    return d->m_queryCacheHitCount;
+}
+
+quint64 QOrmSessionStatistics::queryCacheMissCount() const
+{
+    return d->m_queryCacheMissCount;
+}
+
+quint64 QOrmSessionStatistics::schemaSynchronizationCount() const
+{
+    return d->m_schemaSynchronizationCount;
+}
+
+const QOrmLatencyHistogram& QOrmSessionStatistics::commitLatency() const
+{
+    return d->m_commitLatency;
+}
+
+void QOrmSessionStatistics::reset()
+{
+    d.reset(new QOrmSessionStatisticsPrivate);
+}
+
+void QOrmSessionStatistics::recordStatement(QOrm::Operation operation,
+                                            const QOrmMetadata& entity,
+                                            qint64 executionNanoseconds,
+                                            quint64 rowCount)
+{
+    QOrmStatementStatistics& statistics =
+        d->m_statements[entity.className()][static_cast<size_t>(operation)];
+
+    ++statistics.m_statementCount;
+    statistics.m_rowCount += rowCount;
+    statistics.m_executionLatency.record(executionNanoseconds);
+}
+
+void QOrmSessionStatistics::recordHydration(const QOrmMetadata& entity, qint64 nanoseconds)
+{
+    d->m_statements[entity.className()][static_cast<size_t>(QOrm::Operation::Read)]
+        .m_hydrationLatency.record(nanoseconds);
+}
+
+void QOrmSessionStatistics::recordEntityInstanceCacheLookup(bool isHit)
+{
+    ++(isHit ? d->m_entityInstanceCacheHitCount : d->m_entityInstanceCacheMissCount);
+}
+
+void QOrmSessionStatistics::recordQueryCacheLookup(bool isHit)
+{
+    ++(isHit ? d->m_queryCacheHitCount : d->m_queryCacheMissCount);
+}
+
+void QOrmSessionStatistics::recordSchemaSynchronization()
+{
+    ++d->m_schemaSynchronizationCount;
+}
+
+void QOrmSessionStatistics::recordCommit(qint64 nanoseconds)
+{
+    d->m_commitLatency.record(nanoseconds);
+}
+
+QDebug operator<<(QDebug dbg, const QOrmLatencyHistogram& histogram)
+{
+    QDebugStateSaver saver{dbg};
+
+    dbg.nospace() << "QOrmLatencyHistogram(count " << histogram.count() << ", mean "
+                  << histogram.meanNanoseconds() << " ns, max " << histogram.maxNanoseconds()
+                  << " ns, buckets " << histogram.bucketCounts() << ")";
+
+    return dbg;
+}
+
+QDebug operator<<(QDebug dbg, const QOrmStatementStatistics& statistics)
+{
+    QDebugStateSaver saver{dbg};
+
+    dbg.nospace() << "QOrmStatementStatistics(statements " << statistics.statementCount()
+                  << ", rows " << statistics.rowCount() << ", execution "
+                  << statistics.executionLatency() << ", hydration "
+                  << statistics.hydrationLatency() << ")";
+
+    return dbg;
+}
+
+QT_END_NAMESPACE
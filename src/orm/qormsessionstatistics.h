@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMSESSIONSTATISTICS_H
+#define QORMSESSIONSTATISTICS_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QDebug;
+class QOrmMetadata;
+class QOrmSessionStatisticsPrivate;
+
+// Distribution of durations in buckets with fixed upper bounds of 10, 50, 100, 500 microseconds
+// and so on up to 1 second. Durations above the last bound fall into an overflow bucket.
+class Q_ORM_EXPORT QOrmLatencyHistogram
+{
+public:
+    Q_REQUIRED_RESULT
+    static const QVector<qint64>& bucketUpperBounds();
+
+    void record(qint64 nanoseconds);
+    QOrmLatencyHistogram& operator+=(const QOrmLatencyHistogram& other);
+
+    Q_REQUIRED_RESULT
+    quint64 count() const { return m_count; }
+
+    Q_REQUIRED_RESULT
+    qint64 totalNanoseconds() const { return m_totalNanoseconds; }
+
+    Q_REQUIRED_RESULT
+    qint64 maxNanoseconds() const { return m_maxNanoseconds; }
+
+    Q_REQUIRED_RESULT
+    qint64 meanNanoseconds() const;
+
+    // Sample counts per bucket; the last one is the overflow bucket
+    Q_REQUIRED_RESULT
+    const QVector<quint64>& bucketCounts() const { return m_bucketCounts; }
+
+private:
+    QVector<quint64> m_bucketCounts = QVector<quint64>(bucketUpperBounds().size() + 1, 0);
+    quint64 m_count{0};
+    qint64 m_totalNanoseconds{0};
+    qint64 m_maxNanoseconds{0};
+};
+
+class Q_ORM_EXPORT QOrmStatementStatistics
+{
+public:
+    QOrmStatementStatistics& operator+=(const QOrmStatementStatistics& other);
+
+    Q_REQUIRED_RESULT
+    quint64 statementCount() const { return m_statementCount; }
+
+    // Rows read, or affected by the statement
+    Q_REQUIRED_RESULT
+    quint64 rowCount() const { return m_rowCount; }
+
+    // Time spent preparing and executing the statements in the backend
+    Q_REQUIRED_RESULT
+    const QOrmLatencyHistogram& executionLatency() const { return m_executionLatency; }
+
+    // Time spent fetching the rows of read statements and turning them into entity instances,
+    // including the statements reading the referenced entities
+    Q_REQUIRED_RESULT
+    const QOrmLatencyHistogram& hydrationLatency() const { return m_hydrationLatency; }
+
+private:
+    friend class QOrmSessionStatistics;
+
+    quint64 m_statementCount{0};
+    quint64 m_rowCount{0};
+    QOrmLatencyHistogram m_executionLatency;
+    QOrmLatencyHistogram m_hydrationLatency;
+};
+
+// Counters and latencies of the work done by a session and its provider, see
+// QOrmSession::statistics(). The recording functions are called by the session and by the
+// providers.
+class Q_ORM_EXPORT QOrmSessionStatistics
+{
+    Q_DISABLE_COPY(QOrmSessionStatistics)
+
+public:
+    QOrmSessionStatistics();
+    ~QOrmSessionStatistics();
+
+    // Statements of an operation on all entities
+    Q_REQUIRED_RESULT
+    QOrmStatementStatistics statementStatistics(QOrm::Operation operation) const;
+
+    // Statements of an operation on the entity with the given class name
+    Q_REQUIRED_RESULT
+    QOrmStatementStatistics statementStatistics(QOrm::Operation operation,
+                                                const QString& className) const;
+
+    // Class names of the entities statements were recorded for
+    Q_REQUIRED_RESULT
+    QStringList classNames() const;
+
+    // Rows read resolved to an instance already known to the entity instance cache. Misses are
+    // the rows hydrated to new instances.
+    Q_REQUIRED_RESULT
+    quint64 entityInstanceCacheHitCount() const;
+
+    Q_REQUIRED_RESULT
+    quint64 entityInstanceCacheMissCount() const;
+
+    // Lookups of this session in its query cache, see QOrmSession::setQueryCache()
+    Q_REQUIRED_RESULT
+    quint64 queryCacheHitCount() const;
+
+    Q_REQUIRED_RESULT
+    quint64 queryCacheMissCount() const;
+
+    // Entities whose schema was recreated, updated or validated
+    Q_REQUIRED_RESULT
+    quint64 schemaSynchronizationCount() const;
+
+    Q_REQUIRED_RESULT
+    const QOrmLatencyHistogram& commitLatency() const;
+
+    void reset();
+
+    void recordStatement(QOrm::Operation operation,
+                         const QOrmMetadata& entity,
+                         qint64 executionNanoseconds,
+                         quint64 rowCount);
+    void recordHydration(const QOrmMetadata& entity, qint64 nanoseconds);
+    void recordEntityInstanceCacheLookup(bool isHit);
+    void recordQueryCacheLookup(bool isHit);
+    void recordSchemaSynchronization();
+    void recordCommit(qint64 nanoseconds);
+
+private:
+    QScopedPointer<QOrmSessionStatisticsPrivate> d;
+};
+
+extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmLatencyHistogram& histogram);
+extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmStatementStatistics& statistics);
+
+QT_END_NAMESPACE
+
+#endif // QORMSESSIONSTATISTICS_H
@@ -62,4 +62,24 @@ void QOrmSqliteConfiguration::setSchemaMode(SchemaMode schemaMode)
     m_schemaMode = schemaMode;
 }
 
+int QOrmSqliteConfiguration::slowQueryThreshold() const
+{
+    return m_slowQueryThreshold;
+}
+
+void QOrmSqliteConfiguration::setSlowQueryThreshold(int slowQueryThreshold)
+{
+    m_slowQueryThreshold = slowQueryThreshold;
+}
+
+int QOrmSqliteConfiguration::largeTableThreshold() const
+{
+    return m_largeTableThreshold;
+}
+
+void QOrmSqliteConfiguration::setLargeTableThreshold(int largeTableThreshold)
+{
+    m_largeTableThreshold = largeTableThreshold;
+}
+
 QT_END_NAMESPACE
@@ -54,11 +54,24 @@ public:
     SchemaMode schemaMode() const;
     void setSchemaMode(SchemaMode schemaMode);
 
+    // Statements running longer than this number of milliseconds are logged together with their
+    // query plan. A negative value disables the slow-query log.
+    Q_REQUIRED_RESULT
+    int slowQueryThreshold() const;
+    void setSlowQueryThreshold(int slowQueryThreshold);
+
+    // Full scans of tables with more rows than this are flagged in the slow-query log
+    Q_REQUIRED_RESULT
+    int largeTableThreshold() const;
+    void setLargeTableThreshold(int largeTableThreshold);
+
 private:
     QString m_connectOptions;
     QString m_databaseName;
     bool m_verbose{false};
     SchemaMode m_schemaMode;
+    int m_slowQueryThreshold{-1};
+    int m_largeTableThreshold{10000};
 };
 
 QT_END_NAMESPACE
@@ -30,14 +30,19 @@
 #include "qormorder.h"
 #include "qormpropertymapping.h"
 #include "qormquery.h"
+#include "qormqueryparameter.h"
 #include "qormqueryresult.h"
 #include "qormrelation.h"
+#include "qormrowset.h"
+#include "qormsessionstatistics.h"
 #include "qormsqliteconfiguration.h"
+#include "qormtracer.h"
 
 #include "qormglobal_p.h"
 #include "qormsqlitestatementgenerator_p.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QMetaObject>
 #include <QMetaProperty>
 #include <QObject>
@@ -46,17 +51,40 @@
 #include <QSqlQuery>
 #include <QSqlRecord>
 
+#include <algorithm>
+#include <limits>
+
 QT_BEGIN_NAMESPACE
 
+class QOrmSqlitePreparedStatement : public QOrmPreparedStatement
+{
+public:
+    QOrmSqlitePreparedStatement(const QOrmQuery& query, const QSqlDatabase& database)
+        : m_query{query}
+        , m_sqlQuery{database}
+    {
+    }
+
+    QOrmQuery m_query;
+    QSqlQuery m_sqlQuery;
+    // bound parameter keys of the QOrmQueryParameter placeholders and the parameter names
+    QVector<std::pair<QString, QString>> m_placeholders;
+    QOrmError m_error{QOrm::ErrorType::None, {}};
+};
+
 class QOrmSqliteProviderPrivate
 {
     friend class QOrmSqliteProvider;
 
-    explicit QOrmSqliteProviderPrivate(const QOrmSqliteConfiguration& configuration)
-        : m_sqlConfiguration{configuration}
+    QOrmSqliteProviderPrivate(const QOrmSqliteConfiguration& configuration,
+                              QOrmSqliteProvider* parent)
+        : q_ptr{parent}
+        , m_sqlConfiguration{configuration}
     {
     }
 
+    Q_DECLARE_PUBLIC(QOrmSqliteProvider)
+    QOrmSqliteProvider* q_ptr{nullptr};
     QSqlDatabase m_database;
     QOrmSqliteConfiguration m_sqlConfiguration;
     QSet<QString> m_schemaSyncCache;
@@ -69,12 +97,35 @@ class QOrmSqliteProviderPrivate
 
     Q_REQUIRED_RESULT
     QSqlQuery prepareAndExecute(const QString& statement, const QVariantMap& parameters);
+    QSqlQuery bindArrayParameter(const QString& parameterKey, const QVariantList& values);
+    void dropArrayParameterTables(const QVariantMap& parameters);
+
+    Q_REQUIRED_RESULT
+    bool isSlowQueryLogEnabled() const;
+    Q_REQUIRED_RESULT
+    bool isSlowStatement(qint64 elapsedNs) const;
+    void logSlowStatement(const QString& statement,
+                          const QVariantMap& parameters,
+                          qint64 elapsedNs,
+                          int rowCount);
+    Q_REQUIRED_RESULT
+    qint64 approximateRowCount(const QString& tableName);
+    Q_REQUIRED_RESULT
+    qint64 lastAssignedRowId(const QString& tableName);
+
+    // Records the execution of a create, update or delete statement in the session statistics
+    Q_REQUIRED_RESULT
+    QSqlQuery prepareAndExecuteModification(QOrm::Operation operation,
+                                            const QOrmMetadata& entity,
+                                            const QString& statement,
+                                            const QVariantMap& parameters);
 
     Q_REQUIRED_RESULT
     QOrmPrivate::Expected<QObject*, QOrmError> makeEntityInstance(
         const QOrmMetadata& entityMetadata,
         const QSqlRecord& record,
-        QOrmEntityInstanceCache& entityInstanceCache);
+        QOrmEntityInstanceCache& entityInstanceCache,
+        const QFlags<QOrm::QueryFlags>& queryFlags);
     QOrmError fillEntityInstance(const QOrmMetadata& entityMetadata,
                                  QObject* entityInstance,
                                  const QSqlRecord& record,
@@ -88,7 +139,21 @@ class QOrmSqliteProviderPrivate
 
     QOrmQueryResult<QObject> read(const QOrmQuery& query,
                                   QOrmEntityInstanceCache& entityInstanceCache);
+    QOrmRowSet readRowSet(const QOrmQuery& query,
+                          const std::vector<QOrmPropertyMapping>& columns);
+    QOrmQueryResult<QObject> readResultSet(QSqlQuery& sqlQuery,
+                                           const QOrmQuery& query,
+                                           QOrmEntityInstanceCache& entityInstanceCache);
     QOrmQueryResult<QObject> merge(const QOrmQuery& query);
+    QOrmQueryResult<QObject> mergeBatch(QOrm::Operation operation,
+                                        const QOrmMetadata& entity,
+                                        const QVector<QObject*>& entityInstances);
+    QOrmQueryResult<QObject> insertBatch(QOrm::Operation operation,
+                                         const QOrmMetadata& entity,
+                                         const QVector<QObject*>& entityInstances);
+    QOrmQueryResult<QObject> updateBatch(const QOrmMetadata& entity,
+                                         const QVector<QObject*>& entityInstances);
+    QOrmError insertRowSet(const QOrmMetadata& entity, const QOrmRowSet& rowSet);
     QOrmQueryResult<QObject> remove(const QOrmQuery& query);
 };
 
@@ -101,12 +166,42 @@ QSqlQuery QOrmSqliteProviderPrivate::prepareAndExecute(const QString& statement,
                                                     const QVariantMap& parameters = {})
 {
     QSqlQuery query{m_database};
+    // rows of a result set are read once: do not cache them in the driver
+    query.setForwardOnly(true);
 
     if (m_sqlConfiguration.verbose())
         qCDebug(qtorm) << "Executing:" << statement;
 
-    if (!query.prepare(statement))
-        return query;
+    // The statement refers to the tables of array parameters: fill them before preparing it
+    for (auto it = parameters.begin(); it != parameters.end(); ++it)
+    {
+        if (QOrmSqliteStatementGenerator::isArrayParameter(it.key()))
+        {
+            QSqlQuery arrayQuery = bindArrayParameter(it.key(), it.value().toList());
+
+            // the statement would read a stale or empty table: fail with the binding error
+            if (arrayQuery.lastError().type() != QSqlError::NoError)
+            {
+                dropArrayParameterTables(parameters);
+                return arrayQuery;
+            }
+        }
+    }
+
+    QElapsedTimer timer;
+
+    if (isSlowQueryLogEnabled())
+        timer.start();
+
+    {
+        Q_ORM_TRACE_SCOPE_DETAIL("sqlite", "prepare", statement);
+
+        if (!query.prepare(statement))
+        {
+            dropArrayParameterTables(parameters);
+            return query;
+        }
+    }
 
     if (!parameters.isEmpty())
     {
@@ -114,19 +209,204 @@ QSqlQuery QOrmSqliteProviderPrivate::prepareAndExecute(const QString& statement,
             qCDebug(qtorm) << "Bound parameters:" << parameters;
 
         for (auto it = parameters.begin(); it != parameters.end(); ++it)
-            query.bindValue(it.key(), it.value());
+        {
+            if (!QOrmSqliteStatementGenerator::isArrayParameter(it.key()))
+                query.bindValue(it.key(), it.value());
+        }
+    }
+
+    bool isExecuted = false;
+
+    {
+        Q_ORM_TRACE_SCOPE_DETAIL("sqlite", "execute", statement);
+        isExecuted = query.exec();
     }
 
-    query.exec();
+    // The rows of a SELECT are stepped through later: its caller drops the tables once read
+    if (!isExecuted || !query.isSelect())
+        dropArrayParameterTables(parameters);
+
+    // Rows of a SELECT are stepped through while reading the result set, see read()
+    if (isExecuted && !query.isSelect() && timer.isValid() &&
+        isSlowStatement(timer.nsecsElapsed()))
+    {
+        logSlowStatement(statement, parameters, timer.nsecsElapsed(), query.numRowsAffected());
+    }
 
     return query;
 }
 
+// Returns the query filling the table of the array parameter, which holds the error if any
+QSqlQuery QOrmSqliteProviderPrivate::bindArrayParameter(const QString& parameterKey,
+                                                       const QVariantList& values)
+{
+    QString tableName = QOrmSqliteStatementGenerator::arrayTableName(parameterKey);
+    QSqlQuery query{m_database};
+
+    if (!query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS %1(value)").arg(tableName)) ||
+        !query.exec(QStringLiteral("DELETE FROM %1").arg(tableName)) ||
+        !query.prepare(QStringLiteral("INSERT INTO %1(value) VALUES(?)").arg(tableName)))
+    {
+        return query;
+    }
+
+    query.addBindValue(values);
+    query.execBatch();
+
+    return query;
+}
+
+void QOrmSqliteProviderPrivate::dropArrayParameterTables(const QVariantMap& parameters)
+{
+    QSqlQuery query{m_database};
+
+    for (auto it = parameters.begin(); it != parameters.end(); ++it)
+    {
+        if (!QOrmSqliteStatementGenerator::isArrayParameter(it.key()))
+            continue;
+
+        QString tableName = QOrmSqliteStatementGenerator::arrayTableName(it.key());
+
+        if (!query.exec(QStringLiteral("DROP TABLE IF EXISTS %1").arg(tableName)))
+        {
+            qCWarning(qtorm) << "Unable to drop the table of array parameter" << it.key() << ":"
+                             << query.lastError().text();
+        }
+    }
+}
+
+bool QOrmSqliteProviderPrivate::isSlowQueryLogEnabled() const
+{
+    return m_sqlConfiguration.slowQueryThreshold() >= 0;
+}
+
+bool QOrmSqliteProviderPrivate::isSlowStatement(qint64 elapsedNs) const
+{
+    return isSlowQueryLogEnabled() &&
+           elapsedNs > qint64{m_sqlConfiguration.slowQueryThreshold()} * 1000000;
+}
+
+// Returns the table name of a full scan step in the EXPLAIN QUERY PLAN output, or an empty string.
+// Older SQLite versions report "SCAN TABLE Community AS t", newer ones "SCAN Community".
+static QString scannedTableName(const QString& detail)
+{
+    const QStringList words = detail.split(QLatin1Char(' '), QString::SkipEmptyParts);
+
+    if (words.size() < 2 || words[0] != QLatin1String("SCAN"))
+        return {};
+
+    int nameIndex = words[1] == QLatin1String("TABLE") ? 2 : 1;
+
+    if (nameIndex >= words.size() || words[nameIndex] == QLatin1String("CONSTANT") ||
+        words[nameIndex] == QLatin1String("SUBQUERY"))
+    {
+        return {};
+    }
+
+    return words[nameIndex];
+}
+
+void QOrmSqliteProviderPrivate::logSlowStatement(const QString& statement,
+                                                 const QVariantMap& parameters,
+                                                 qint64 elapsedNs,
+                                                 int rowCount)
+{
+    qCWarning(qtorm).noquote().nospace()
+        << "Slow statement (" << elapsedNs / 1000000.0 << " ms, " << rowCount
+        << " rows): " << statement;
+
+    if (!parameters.isEmpty())
+        qCWarning(qtorm) << "Bound parameters:" << parameters;
+
+    QSqlQuery planQuery{m_database};
+
+    if (!planQuery.prepare(QStringLiteral("EXPLAIN QUERY PLAN ") + statement))
+    {
+        qCWarning(qtorm) << "Unable to explain the query plan:" << planQuery.lastError().text();
+        return;
+    }
+
+    for (auto it = parameters.begin(); it != parameters.end(); ++it)
+    {
+        if (!QOrmSqliteStatementGenerator::isArrayParameter(it.key()))
+            planQuery.bindValue(it.key(), it.value());
+    }
+
+    if (!planQuery.exec())
+    {
+        qCWarning(qtorm) << "Unable to explain the query plan:" << planQuery.lastError().text();
+        return;
+    }
+
+    QStringList plan;
+
+    while (planQuery.next())
+        plan.push_back(planQuery.value(QStringLiteral("detail")).toString());
+
+    planQuery.finish();
+
+    for (const QString& detail : qAsConst(plan))
+    {
+        qCWarning(qtorm).noquote() << "Query plan:" << detail;
+
+        QString tableName = scannedTableName(detail);
+
+        if (tableName.isEmpty())
+            continue;
+
+        qint64 tableRowCount = approximateRowCount(tableName);
+
+        if (tableRowCount > m_sqlConfiguration.largeTableThreshold())
+        {
+            qCWarning(qtorm).noquote() << "Full scan of large table" << tableName << "with about"
+                                       << tableRowCount << "rows";
+        }
+    }
+}
+
+// The largest rowid is a cheap upper bound of the row count: it is looked up in the table b-tree
+// instead of counting every row. Returns -1 if the name does not refer to a table, e.g. an alias.
+qint64 QOrmSqliteProviderPrivate::approximateRowCount(const QString& tableName)
+{
+    QSqlQuery query{m_database};
+
+    if (!query.exec(QStringLiteral("SELECT MAX(rowid) FROM %1").arg(tableName)) || !query.next())
+        return -1;
+
+    return query.value(0).toLongLong();
+}
+
+// The rowid SQLite assigns to an inserted row is one past the largest rowid of the table and, for
+// AUTOINCREMENT tables, the largest one ever used. Returns -1 if the table cannot be read.
+qint64 QOrmSqliteProviderPrivate::lastAssignedRowId(const QString& tableName)
+{
+    QSqlQuery query{m_database};
+
+    if (!query.exec(QStringLiteral("SELECT MAX(rowid) FROM %1").arg(tableName)) || !query.next())
+        return -1;
+
+    qint64 rowId = query.value(0).toLongLong();
+
+    // sqlite_sequence only exists once an AUTOINCREMENT table has been created
+    if (query.prepare(QStringLiteral("SELECT seq FROM sqlite_sequence WHERE name = ?")))
+    {
+        query.addBindValue(tableName);
+
+        if (query.exec() && query.next())
+            rowId = std::max(rowId, query.value(0).toLongLong());
+    }
+
+    return rowId;
+}
+
 QOrmPrivate::Expected<QObject*, QOrmError> QOrmSqliteProviderPrivate::makeEntityInstance(
     const QOrmMetadata& entityMetadata,
     const QSqlRecord& record,
-    QOrmEntityInstanceCache& entityInstanceCache)
+    QOrmEntityInstanceCache& entityInstanceCache,
+    const QFlags<QOrm::QueryFlags>& queryFlags)
 {
+    const bool isTracked = !queryFlags.testFlag(QOrm::QueryFlags::NoTracking);
+
     QObject* entityInstance = entityMetadata.qMetaObject().newInstance();
     Q_ASSERT(entityInstance != nullptr);
 
@@ -142,14 +422,19 @@ QOrmPrivate::Expected<QObject*, QOrmError> QOrmSqliteProviderPrivate::makeEntity
 
     entityInstanceCache.insert(entityMetadata, entityInstance);
 
-    // fill the rest of the properties
-    QOrmError fillError = fillEntityInstance(
-        entityMetadata, entityInstance, record, entityInstanceCache, QOrm::QueryFlags::None);
+    // fill the rest of the properties; the referenced instances are read untracked as well
+    QOrmError fillError = fillEntityInstance(entityMetadata,
+                                             entityInstance,
+                                             record,
+                                             entityInstanceCache,
+                                             queryFlags & QOrm::QueryFlags::NoTracking);
 
     if (fillError != QOrm::ErrorType::None)
         return QOrmPrivate::makeUnexpected(fillError);
 
-    entityInstanceCache.finalize(entityMetadata, entityInstance);
+    // untracked instances are not watched for changes
+    if (isTracked)
+        entityInstanceCache.finalize(entityMetadata, entityInstance);
 
     return entityInstance;
 }
@@ -161,6 +446,8 @@ QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
     QOrmEntityInstanceCache& entityInstanceCache,
     const QFlags<QOrm::QueryFlags>& queryFlags)
 {
+    Q_ORM_TRACE_SCOPE_DETAIL("sqlite", "hydrate", entityMetadata.className());
+
     for (const QOrmPropertyMapping& mapping : entityMetadata.propertyMappings())
     {
         // if this property is a reference, retrieve referenced entity instances and assign
@@ -175,7 +462,7 @@ QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
             // transient references are one-to-many references
             if (mapping.isTransient())
             {
-                const QOrmPropertyMapping* backReference = QOrmPrivate::backReference(mapping);
+                const QOrmPropertyMapping* backReference = mapping.backReference();
                 Q_ASSERT(backReference != nullptr);
                 Q_ASSERT(entityMetadata.objectIdMapping() != nullptr);
 
@@ -232,6 +519,12 @@ QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
                 QObject* referencedEntityInstance =
                     entityInstanceCache.get(*mapping.referencedEntity(), referencedObjectId);
 
+                if (QOrmSessionStatistics* statistics = q_ptr->statistics())
+                {
+                    statistics->recordEntityInstanceCacheLookup(referencedEntityInstance !=
+                                                                nullptr);
+                }
+
                 // referenced instance is in cache: check that it wasn't modified and assign to the
                 // corresponding property
                 if (referencedEntityInstance != nullptr)
@@ -321,6 +614,10 @@ QOrmError QOrmSqliteProviderPrivate::ensureSchemaSynchronized(const QOrmRelation
             if (m_schemaSyncCache.contains(relation.mapping()->className()))
                 return {QOrm::ErrorType::None, ""};
 
+            Q_ORM_TRACE_SCOPE_DETAIL("sqlite",
+                                     "synchronizeSchema",
+                                     relation.mapping()->className());
+
             std::optional<QOrmError> error;
 
             switch (m_sqlConfiguration.schemaMode())
@@ -343,6 +640,9 @@ QOrmError QOrmSqliteProviderPrivate::ensureSchemaSynchronized(const QOrmRelation
 
             Q_ASSERT(error.has_value());
 
+            if (QOrmSessionStatistics* statistics = q_ptr->statistics())
+                statistics->recordSchemaSynchronization();
+
             if (error->type() == QOrm::ErrorType::None)
             {
                 m_schemaSyncCache.insert(relation.mapping()->className());
@@ -466,12 +766,129 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
 
     auto [statement, boundParameters] = QOrmSqliteStatementGenerator::generate(query);
 
+    QOrmSessionStatistics* statistics = q_ptr->statistics();
+    QElapsedTimer timer;
+
+    if (statistics != nullptr || isSlowQueryLogEnabled())
+        timer.start();
+
     QSqlQuery sqlQuery = prepareAndExecute(statement, boundParameters);
 
     if (sqlQuery.lastError().type() != QSqlError::NoError)
         return QOrmQueryResult<QObject>{
             QOrmError{QOrm::ErrorType::Provider, sqlQuery.lastError().text()}};
 
+    // Rows are fetched while hydrating, so this only accounts for the first step of the statement
+    qint64 executionTime = timer.isValid() ? timer.nsecsElapsed() : 0;
+
+    if (timer.isValid())
+        timer.start();
+
+    QOrmQueryResult<QObject> result = readResultSet(sqlQuery, query, entityInstanceCache);
+
+    // the tables of array parameters cannot be dropped while the statement is active
+    sqlQuery.finish();
+    dropArrayParameterTables(boundParameters);
+
+    if (!timer.isValid())
+        return result;
+
+    qint64 hydrationTime = timer.nsecsElapsed();
+    int rowCount = result.toVector().size();
+
+    if (statistics != nullptr)
+    {
+        statistics->recordHydration(*query.projection(), hydrationTime);
+        statistics->recordStatement(QOrm::Operation::Read,
+                                    *query.projection(),
+                                    executionTime,
+                                    static_cast<quint64>(rowCount));
+    }
+
+    // The whole result set is stepped through while hydrating, including the referenced entities
+    if (isSlowStatement(executionTime + hydrationTime))
+        logSlowStatement(statement, boundParameters, executionTime + hydrationTime, rowCount);
+
+    return result;
+}
+
+QOrmRowSet QOrmSqliteProviderPrivate::readRowSet(const QOrmQuery& query,
+                                                 const std::vector<QOrmPropertyMapping>& columns)
+{
+    Q_ASSERT(query.projection().has_value());
+
+    QVariantMap boundParameters;
+    QString statement =
+        QOrmSqliteStatementGenerator::generateSelectStatement(query, columns, boundParameters);
+
+    QOrmSessionStatistics* statistics = q_ptr->statistics();
+    QElapsedTimer timer;
+
+    if (statistics != nullptr || isSlowQueryLogEnabled())
+        timer.start();
+
+    QSqlQuery sqlQuery = prepareAndExecute(statement, boundParameters);
+
+    if (sqlQuery.lastError().type() != QSqlError::NoError)
+        return QOrmRowSet{QOrmError{QOrm::ErrorType::Provider, sqlQuery.lastError().text()}};
+
+    qint64 executionTime = timer.isValid() ? timer.nsecsElapsed() : 0;
+
+    if (timer.isValid())
+        timer.start();
+
+    QStringList columnNames;
+    columnNames.reserve(static_cast<int>(columns.size()));
+
+    for (const QOrmPropertyMapping& column : columns)
+        columnNames.push_back(column.classPropertyName());
+
+    QOrmRowSet rowSet{columnNames};
+    QVector<QVariant> values(columnNames.size());
+
+    // the columns are selected in their order: no lookup by name
+    while (sqlQuery.next())
+    {
+        for (int i = 0; i < values.size(); ++i)
+            values[i] = sqlQuery.value(i);
+
+        rowSet.appendRow(values);
+    }
+
+    // the tables of array parameters cannot be dropped while the statement is active
+    sqlQuery.finish();
+    dropArrayParameterTables(boundParameters);
+
+    if (!timer.isValid())
+        return rowSet;
+
+    qint64 fetchTime = timer.nsecsElapsed();
+
+    if (statistics != nullptr)
+    {
+        statistics->recordHydration(*query.projection(), fetchTime);
+        statistics->recordStatement(QOrm::Operation::Read,
+                                    *query.projection(),
+                                    executionTime,
+                                    static_cast<quint64>(rowSet.rowCount()));
+    }
+
+    if (isSlowStatement(executionTime + fetchTime))
+    {
+        logSlowStatement(statement,
+                         boundParameters,
+                         executionTime + fetchTime,
+                         rowSet.rowCount());
+    }
+
+    return rowSet;
+}
+
+QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::readResultSet(
+    QSqlQuery& sqlQuery,
+    const QOrmQuery& query,
+    QOrmEntityInstanceCache& entityInstanceCache)
+{
     QVector<QObject*> resultSet;
 
     const QOrmPropertyMapping* objectIdMapping = query.projection()->objectIdMapping();
@@ -487,6 +904,9 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
 
             QObject* cachedInstance = entityInstanceCache.get(*query.projection(), objectId);
 
+            if (QOrmSessionStatistics* statistics = q_ptr->statistics())
+                statistics->recordEntityInstanceCacheLookup(cachedInstance != nullptr);
+
             // cached instance: check if consistent
             if (cachedInstance != nullptr)
             {
@@ -512,11 +932,10 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
                                                          entityInstanceCache,
                                                          query.flags());
 
+                    entityInstanceCache.markUnmodified(cachedInstance);
+
                     if (error != QOrm::ErrorType::None)
-                    {
-                        entityInstanceCache.markUnmodified(cachedInstance);
                         return QOrmQueryResult<QObject>{error};
-                    }
                 }
 
                 resultSet.push_back(cachedInstance);
@@ -525,7 +944,10 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
             else
             {
                 QOrmPrivate::Expected<QObject*, QOrmError> entityInstance =
-                    makeEntityInstance(*query.projection(), sqlQuery.record(), entityInstanceCache);
+                    makeEntityInstance(*query.projection(),
+                                       sqlQuery.record(),
+                                       entityInstanceCache,
+                                       query.flags());
 
                 if (entityInstance)
                 {
@@ -544,7 +966,10 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
         while (sqlQuery.next())
         {
             QOrmPrivate::Expected<QObject*, QOrmError> entityInstance =
-                makeEntityInstance(*query.projection(), sqlQuery.record(), entityInstanceCache);
+                makeEntityInstance(*query.projection(),
+                                   sqlQuery.record(),
+                                   entityInstanceCache,
+                                   query.flags());
 
             if (entityInstance)
             {
@@ -563,6 +988,32 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
     return QOrmQueryResult<QObject>{resultSet};
 }
 
+QSqlQuery QOrmSqliteProviderPrivate::prepareAndExecuteModification(QOrm::Operation operation,
+                                                                  const QOrmMetadata& entity,
+                                                                  const QString& statement,
+                                                                  const QVariantMap& parameters)
+{
+    QOrmSessionStatistics* statistics = q_ptr->statistics();
+
+    if (statistics == nullptr)
+        return prepareAndExecute(statement, parameters);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QSqlQuery sqlQuery = prepareAndExecute(statement, parameters);
+
+    if (sqlQuery.lastError().type() == QSqlError::NoError)
+    {
+        statistics->recordStatement(operation,
+                                    entity,
+                                    timer.nsecsElapsed(),
+                                    static_cast<quint64>(std::max(sqlQuery.numRowsAffected(), 0)));
+    }
+
+    return sqlQuery;
+}
+
 QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::merge(const QOrmQuery& query)
 {
     Q_ASSERT(query.relation().type() == QOrm::RelationType::Mapping);
@@ -570,12 +1021,16 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::merge(const QOrmQuery& query
 
     auto [statement, boundParameters] = QOrmSqliteStatementGenerator::generate(query);
 
-    QSqlQuery sqlQuery = prepareAndExecute(statement, boundParameters);
+    QSqlQuery sqlQuery = prepareAndExecuteModification(query.operation(),
+                                                       *query.relation().mapping(),
+                                                       statement,
+                                                       boundParameters);
 
     if (sqlQuery.lastError().type() != QSqlError::NoError)
         return QOrmQueryResult<QObject>{{QOrm::ErrorType::Provider, sqlQuery.lastError().text()}};
 
-    if (sqlQuery.numRowsAffected() != 1)
+    // an upsert of an entity without other columns does nothing if the row exists
+    if (sqlQuery.numRowsAffected() != 1 && query.operation() != QOrm::Operation::Merge)
     {
         return QOrmQueryResult<QObject>{
             {QOrm::ErrorType::UnsynchronizedEntity, "Unexpected number of rows affected"}};
@@ -584,11 +1039,242 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::merge(const QOrmQuery& query
     return QOrmQueryResult<QObject>{sqlQuery.lastInsertId()};
 }
 
+QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::mergeBatch(
+    QOrm::Operation operation,
+    const QOrmMetadata& entity,
+    const QVector<QObject*>& entityInstances)
+{
+    QOrmError error = ensureSchemaSynchronized(QOrmRelation{entity});
+
+    if (error.type() != QOrm::ErrorType::None)
+        return QOrmQueryResult<QObject>{error};
+
+    switch (operation)
+    {
+        case QOrm::Operation::Create:
+        case QOrm::Operation::Merge:
+            return insertBatch(operation, entity, entityInstances);
+
+        case QOrm::Operation::Update:
+            return updateBatch(entity, entityInstances);
+
+        default:
+            Q_ORM_UNEXPECTED_STATE;
+    }
+}
+
+// Creates or upserts the instances with as few multi-row statements as the limit of bound
+// parameters allows
+QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::insertBatch(
+    QOrm::Operation operation,
+    const QOrmMetadata& entity,
+    const QVector<QObject*>& entityInstances)
+{
+    const QOrmPropertyMapping* objectIdMapping = entity.objectIdMapping();
+    const bool isObjectIdGenerated = operation == QOrm::Operation::Create &&
+                                     objectIdMapping != nullptr &&
+                                     objectIdMapping->isAutogenerated();
+    const int batchSize = QOrmSqliteStatementGenerator::maxBatchSize(operation, entity);
+
+    QVariantList objectIds;
+    objectIds.reserve(entityInstances.size());
+
+    for (int first = 0; first < entityInstances.size();)
+    {
+        int rowCount = std::min(batchSize, entityInstances.size() - first);
+        qint64 lastRowId = 0;
+
+        // The rows of an INSERT get consecutive rowids following the last assigned one, unless
+        // the largest rowid is reached: SQLite then picks unused rowids at random, and the rows
+        // are inserted one at a time to read each of them.
+        if (isObjectIdGenerated)
+        {
+            lastRowId = lastAssignedRowId(entity.tableName());
+
+            if (lastRowId < 0)
+            {
+                return QOrmQueryResult<QObject>{
+                    {QOrm::ErrorType::Provider,
+                     QStringLiteral("Unable to read the rowids of %1").arg(entity.tableName())}};
+            }
+
+            if (lastRowId > std::numeric_limits<qint64>::max() - rowCount)
+                rowCount = 1;
+        }
+
+        const QVector<QObject*> batch = entityInstances.mid(first, rowCount);
+        first += rowCount;
+
+        QVariantMap boundParameters;
+        QString statement =
+            operation == QOrm::Operation::Create
+                ? QOrmSqliteStatementGenerator::generateInsertStatement(entity,
+                                                                        batch,
+                                                                        boundParameters)
+                : QOrmSqliteStatementGenerator::generateUpsertStatement(entity,
+                                                                        batch,
+                                                                        boundParameters);
+
+        QSqlQuery sqlQuery =
+            prepareAndExecuteModification(operation, entity, statement, boundParameters);
+
+        if (sqlQuery.lastError().type() != QSqlError::NoError)
+        {
+            return QOrmQueryResult<QObject>{
+                {QOrm::ErrorType::Provider, sqlQuery.lastError().text()}};
+        }
+
+        if (operation == QOrm::Operation::Create && sqlQuery.numRowsAffected() != batch.size())
+        {
+            return QOrmQueryResult<QObject>{
+                {QOrm::ErrorType::UnsynchronizedEntity, "Unexpected number of rows affected"}};
+        }
+
+        qint64 lastInsertId = sqlQuery.lastInsertId().toLongLong();
+
+        // e.g. a trigger inserted rows into the same table
+        if (isObjectIdGenerated && batch.size() > 1 && lastInsertId != lastRowId + batch.size())
+        {
+            return QOrmQueryResult<QObject>{
+                {QOrm::ErrorType::UnsynchronizedEntity,
+                 QStringLiteral("Rows inserted into %1 got non-consecutive rowids")
+                     .arg(entity.tableName())}};
+        }
+
+        for (int i = 0; i < batch.size(); ++i)
+        {
+            if (isObjectIdGenerated)
+                objectIds.push_back(lastInsertId - batch.size() + 1 + i);
+            else if (objectIdMapping != nullptr)
+                objectIds.push_back(QOrmPrivate::objectIdPropertyValue(batch[i], entity));
+            else
+                objectIds.push_back(QVariant{});
+        }
+    }
+
+    return QOrmQueryResult<QObject>{QVariant{objectIds}};
+}
+
+// Inserts the rows with as few multi-row statements as the limit of bound parameters allows
+QOrmError QOrmSqliteProviderPrivate::insertRowSet(const QOrmMetadata& entity,
+                                                  const QOrmRowSet& rowSet)
+{
+    const int batchSize =
+        QOrmSqliteStatementGenerator::maxBatchSize(QOrm::Operation::Create, entity);
+
+    for (int first = 0; first < rowSet.rowCount(); first += batchSize)
+    {
+        const int rowCount = std::min(batchSize, rowSet.rowCount() - first);
+
+        QVariantMap boundParameters;
+        QString statement = QOrmSqliteStatementGenerator::generateInsertStatement(entity,
+                                                                                  rowSet,
+                                                                                  first,
+                                                                                  rowCount,
+                                                                                  boundParameters);
+
+        QSqlQuery sqlQuery = prepareAndExecuteModification(QOrm::Operation::Create,
+                                                           entity,
+                                                           statement,
+                                                           boundParameters);
+
+        if (sqlQuery.lastError().type() != QSqlError::NoError)
+            return QOrmError{QOrm::ErrorType::Provider, sqlQuery.lastError().text()};
+
+        if (sqlQuery.numRowsAffected() != rowCount)
+        {
+            return QOrmError{QOrm::ErrorType::UnsynchronizedEntity,
+                             "Unexpected number of rows affected"};
+        }
+    }
+
+    return QOrmError{QOrm::ErrorType::None, {}};
+}
+
+// Updates the instances with the UPDATE statement of the entity prepared once
+QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::updateBatch(
+    const QOrmMetadata& entity,
+    const QVector<QObject*>& entityInstances)
+{
+    QOrmSessionStatistics* statistics = q_ptr->statistics();
+    QSqlQuery sqlQuery{m_database};
+    QVariantMap boundParameters;
+
+    const QString statement = QOrmSqliteStatementGenerator::generateUpdateStatement(
+        entity, entityInstances.front(), boundParameters);
+
+    if (m_sqlConfiguration.verbose())
+        qCDebug(qtorm) << "Preparing:" << statement;
+
+    {
+        Q_ORM_TRACE_SCOPE_DETAIL("sqlite", "prepare", statement);
+
+        if (!sqlQuery.prepare(statement))
+        {
+            return QOrmQueryResult<QObject>{
+                {QOrm::ErrorType::Provider, sqlQuery.lastError().text()}};
+        }
+    }
+
+    QVariantList objectIds;
+    objectIds.reserve(entityInstances.size());
+
+    for (QObject* entityInstance : entityInstances)
+    {
+        // the cached statement is returned for each instance, only the values differ
+        boundParameters.clear();
+        const QString instanceStatement = QOrmSqliteStatementGenerator::generateUpdateStatement(
+            entity, entityInstance, boundParameters);
+        Q_ASSERT(instanceStatement == statement);
+        Q_UNUSED(instanceStatement)
+
+        for (auto it = boundParameters.cbegin(); it != boundParameters.cend(); ++it)
+            sqlQuery.bindValue(it.key(), it.value());
+
+        if (m_sqlConfiguration.verbose())
+            qCDebug(qtorm) << "Bound parameters:" << boundParameters;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        {
+            Q_ORM_TRACE_SCOPE_DETAIL("sqlite", "execute", statement);
+
+            if (!sqlQuery.exec())
+            {
+                return QOrmQueryResult<QObject>{
+                    {QOrm::ErrorType::Provider, sqlQuery.lastError().text()}};
+            }
+        }
+
+        qint64 elapsedNs = timer.nsecsElapsed();
+
+        if (sqlQuery.numRowsAffected() != 1)
+        {
+            return QOrmQueryResult<QObject>{
+                {QOrm::ErrorType::UnsynchronizedEntity, "Unexpected number of rows affected"}};
+        }
+
+        if (statistics != nullptr)
+            statistics->recordStatement(QOrm::Operation::Update, entity, elapsedNs, 1);
+
+        if (isSlowStatement(elapsedNs))
+            logSlowStatement(statement, boundParameters, elapsedNs, 1);
+
+        objectIds.push_back(QOrmPrivate::objectIdPropertyValue(entityInstance, entity));
+    }
+
+    return QOrmQueryResult<QObject>{QVariant{objectIds}};
+}
+
 QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::remove(const QOrmQuery& query)
 {
     auto [statement, boundParameters] = QOrmSqliteStatementGenerator::generate(query);
 
-    QSqlQuery sqlQuery = prepareAndExecute(statement, boundParameters);
+    QSqlQuery sqlQuery = prepareAndExecuteModification(query.operation(),
+                                                       *query.relation().mapping(),
+                                                       statement,
+                                                       boundParameters);
 
     if (sqlQuery.lastError().type() != QSqlError::NoError)
         return QOrmQueryResult<QObject>{{QOrm::ErrorType::Provider, sqlQuery.lastError().text()}};
@@ -598,7 +1284,7 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::remove(const QOrmQuery& quer
 
 QOrmSqliteProvider::QOrmSqliteProvider(const QOrmSqliteConfiguration& sqlConfiguration)
     : QOrmAbstractProvider{}
-    , d_ptr{new QOrmSqliteProviderPrivate{sqlConfiguration}}
+    , d_ptr{new QOrmSqliteProviderPrivate{sqlConfiguration, this}}
 {
 }
 
@@ -708,16 +1394,212 @@ QOrmQueryResult<QObject> QOrmSqliteProvider::execute(const QOrmQuery& query,
 
         case QOrm::Operation::Create:
         case QOrm::Operation::Update:
+        case QOrm::Operation::Merge:
             return d->merge(query);
 
         case QOrm::Operation::Delete:
             return d->remove(query);
+    }
 
+    Q_ORM_UNEXPECTED_STATE;
+}
+
+QOrmRowSet QOrmSqliteProvider::executeRowSet(const QOrmQuery& query,
+                                             const std::vector<QOrmPropertyMapping>& columns)
+{
+    Q_D(QOrmSqliteProvider);
+
+    Q_ASSERT(query.operation() == QOrm::Operation::Read);
+
+    QOrmError error = d->ensureSchemaSynchronized(query.relation());
+
+    if (error.type() != QOrm::ErrorType::None)
+        return QOrmRowSet{error};
+
+    return d->readRowSet(query, columns);
+}
+
+QOrmError QOrmSqliteProvider::insertRowSet(const QOrmMetadata& entity, const QOrmRowSet& rowSet)
+{
+    Q_D(QOrmSqliteProvider);
+
+    if (rowSet.rowCount() == 0)
+        return QOrmError{QOrm::ErrorType::None, {}};
+
+    QOrmError error = d->ensureSchemaSynchronized(QOrmRelation{entity});
+
+    if (error.type() != QOrm::ErrorType::None)
+        return error;
+
+    return d->insertRowSet(entity, rowSet);
+}
+
+QOrmQueryResult<QObject> QOrmSqliteProvider::executeBatch(
+    QOrm::Operation operation,
+    const QOrmMetadata& entity,
+    const QVector<QObject*>& entityInstances,
+    QOrmEntityInstanceCache& entityInstanceCache)
+{
+    Q_D(QOrmSqliteProvider);
+
+    if (entityInstances.isEmpty())
+        return QOrmQueryResult<QObject>{QVariant{QVariantList{}}};
+
+    switch (operation)
+    {
+        case QOrm::Operation::Create:
+        case QOrm::Operation::Update:
         case QOrm::Operation::Merge:
-            Q_ORM_UNEXPECTED_STATE;
+            return d->mergeBatch(operation, entity, entityInstances);
+
+        default:
+            return QOrmAbstractProvider::executeBatch(operation,
+                                                      entity,
+                                                      entityInstances,
+                                                      entityInstanceCache);
     }
+}
 
-    Q_ORM_UNEXPECTED_STATE;
+std::unique_ptr<QOrmPreparedStatement> QOrmSqliteProvider::prepare(const QOrmQuery& query)
+{
+    Q_D(QOrmSqliteProvider);
+
+    Q_ASSERT(query.operation() == QOrm::Operation::Read);
+    Q_ASSERT(query.projection().has_value());
+
+    auto preparedStatement = std::make_unique<QOrmSqlitePreparedStatement>(query, d->m_database);
+
+    QOrmError error = d->ensureSchemaSynchronized(query.relation());
+
+    if (error.type() != QOrm::ErrorType::None)
+    {
+        preparedStatement->m_error = error;
+        return preparedStatement;
+    }
+
+    auto [statement, boundParameters] = QOrmSqliteStatementGenerator::generate(query);
+    QSqlQuery& sqlQuery = preparedStatement->m_sqlQuery;
+
+    if (d->m_sqlConfiguration.verbose())
+        qCDebug(qtorm) << "Preparing:" << statement;
+
+    // Array parameters are materialized in prepareAndExecute(), which prepared statements bypass
+    const QStringList parameterKeys = boundParameters.keys();
+
+    if (std::any_of(std::cbegin(parameterKeys),
+                    std::cend(parameterKeys),
+                    &QOrmSqliteStatementGenerator::isArrayParameter))
+    {
+        preparedStatement->m_error =
+            QOrmError{QOrm::ErrorType::Other,
+                      QStringLiteral("Prepared queries do not support IN lists longer than %1")
+                          .arg(QOrmSqliteStatementGenerator::MaxInlineArraySize)};
+        return preparedStatement;
+    }
+
+    sqlQuery.setForwardOnly(true);
+
+    {
+        Q_ORM_TRACE_SCOPE_DETAIL("sqlite", "prepare", statement);
+
+        if (!sqlQuery.prepare(statement))
+        {
+            preparedStatement->m_error =
+                QOrmError{QOrm::ErrorType::Provider, sqlQuery.lastError().text()};
+            return preparedStatement;
+        }
+    }
+
+    // Bound values stay with the QSqlQuery: only the placeholders are bound on each execution
+    for (auto it = boundParameters.cbegin(); it != boundParameters.cend(); ++it)
+    {
+        if (it.value().userType() == qMetaTypeId<QOrmQueryParameter>())
+        {
+            preparedStatement->m_placeholders.push_back(
+                {it.key(), it.value().value<QOrmQueryParameter>().name()});
+        }
+        else
+        {
+            sqlQuery.bindValue(it.key(), it.value());
+        }
+    }
+
+    return preparedStatement;
+}
+
+QOrmQueryResult<QObject> QOrmSqliteProvider::execute(QOrmPreparedStatement& statement,
+                                                     const QVariantMap& parameterValues,
+                                                     QOrmEntityInstanceCache& entityInstanceCache)
+{
+    Q_D(QOrmSqliteProvider);
+
+    auto& preparedStatement = static_cast<QOrmSqlitePreparedStatement&>(statement);
+
+    if (preparedStatement.m_error.type() != QOrm::ErrorType::None)
+        return QOrmQueryResult<QObject>{preparedStatement.m_error};
+
+    QSqlQuery& sqlQuery = preparedStatement.m_sqlQuery;
+
+    for (const auto& [parameterKey, parameterName] : preparedStatement.m_placeholders)
+    {
+        auto it = parameterValues.find(parameterName);
+
+        if (it == parameterValues.end())
+        {
+            return QOrmQueryResult<QObject>{
+                QOrmError{QOrm::ErrorType::Other,
+                          QStringLiteral("No value bound to query parameter %1").arg(parameterName)}};
+        }
+
+        sqlQuery.bindValue(parameterKey, it.value());
+    }
+
+    if (d->m_sqlConfiguration.verbose())
+    {
+        qCDebug(qtorm) << "Executing:" << sqlQuery.lastQuery();
+        qCDebug(qtorm) << "Parameter values:" << parameterValues;
+    }
+
+    QOrmSessionStatistics* statistics = this->statistics();
+    QElapsedTimer timer;
+
+    if (statistics != nullptr)
+        timer.start();
+
+    {
+        Q_ORM_TRACE_SCOPE_DETAIL("sqlite", "execute", sqlQuery.lastQuery());
+
+        if (!sqlQuery.exec())
+            return QOrmQueryResult<QObject>{
+                QOrmError{QOrm::ErrorType::Provider, sqlQuery.lastError().text()}};
+    }
+
+    qint64 executionTime = 0;
+
+    if (statistics != nullptr)
+    {
+        executionTime = timer.nsecsElapsed();
+        timer.start();
+    }
+
+    QOrmQueryResult<QObject> result =
+        d->readResultSet(sqlQuery, preparedStatement.m_query, entityInstanceCache);
+
+    if (statistics != nullptr)
+    {
+        const QOrmMetadata& projection = *preparedStatement.m_query.projection();
+
+        statistics->recordHydration(projection, timer.nsecsElapsed());
+        statistics->recordStatement(QOrm::Operation::Read,
+                                    projection,
+                                    executionTime,
+                                    static_cast<quint64>(result.toVector().size()));
+    }
+
+    // release the result set but keep the prepared statement
+    sqlQuery.finish();
+
+    return result;
 }
 
 QOrmSqliteConfiguration QOrmSqliteProvider::configuration() const
@@ -50,6 +50,21 @@ public:
     QOrmQueryResult<QObject> execute(const QOrmQuery& query,
                                      QOrmEntityInstanceCache& entityInstanceCache) override;
 
+    QOrmQueryResult<QObject> executeBatch(QOrm::Operation operation,
+                                          const QOrmMetadata& entity,
+                                          const QVector<QObject*>& entityInstances,
+                                          QOrmEntityInstanceCache& entityInstanceCache) override;
+
+    QOrmRowSet executeRowSet(const QOrmQuery& query,
+                             const std::vector<QOrmPropertyMapping>& columns) override;
+
+    QOrmError insertRowSet(const QOrmMetadata& entity, const QOrmRowSet& rowSet) override;
+
+    std::unique_ptr<QOrmPreparedStatement> prepare(const QOrmQuery& query) override;
+    QOrmQueryResult<QObject> execute(QOrmPreparedStatement& statement,
+                                     const QVariantMap& parameterValues,
+                                     QOrmEntityInstanceCache& entityInstanceCache) override;
+
     QOrmSqliteConfiguration configuration() const;
     QSqlDatabase database() const;
 
@@ -23,13 +23,20 @@
 #include "qormfilterexpression.h"
 #include "qormglobal_p.h"
 #include "qormmetadata.h"
+#include "qormmetadata_p.h"
 #include "qormmetadatacache.h"
 #include "qormorder.h"
 #include "qormquery.h"
+#include "qormqueryparameter.h"
 #include "qormrelation.h"
+#include "qormrowset.h"
 
 #include <QtCore/qstringbuilder.h>
 
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+
 QT_BEGIN_NAMESPACE
 
 static QString insertParameter(QVariantMap& boundParameters, QString name, QVariant value)
@@ -68,12 +75,630 @@ static QVariant propertyValueForQuery(const QObject* entityInstance,
     }
 }
 
+// Statements are rendered into one buffer reserved up front; this covers typical statements
+// without reallocations
+static constexpr int InitialStatementCapacity = 256;
+
+static void appendSelectStatement(QString& statement,
+                                  const QOrmQuery& query,
+                                  QVariantMap& boundParameters,
+                                  const std::vector<QOrmPropertyMapping>* columns = nullptr);
+static void appendCondition(QString& statement,
+                            const QOrmFilterExpression& expression,
+                            QVariantMap& boundParameters,
+                            const QString& qualifier);
+
+static bool isAlwaysTrue(const QOrmFilter& filter)
+{
+    if (filter.type() != QOrm::FilterType::Expression)
+        return true;
+
+    Q_ASSERT(filter.expression() != nullptr);
+
+    const QOrmFilterNaryPredicate* nary = filter.expression()->naryPredicate();
+
+    return nary != nullptr && nary->logicalOperator() == QOrm::BinaryLogicalOperator::And &&
+           nary->operands().isEmpty();
+}
+
+static bool hasPropertyPaths(const QOrmFilterExpression& expression)
+{
+    const auto predicates = QOrmPrivate::terminalPredicates(expression);
+
+    return std::any_of(std::cbegin(predicates),
+                       std::cend(predicates),
+                       [](const QOrmFilterTerminalPredicate* predicate) {
+                           return !predicate->path().empty();
+                       });
+}
+
+// Table alias of the entity reached by the first length references of a property path
+static void appendJoinAlias(QString& statement,
+                            const std::vector<QOrmPropertyMapping>& path,
+                            size_t length)
+{
+    Q_ASSERT(length > 0 && length <= path.size());
+
+    statement += QLatin1Char('j');
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        statement += QLatin1Char('_');
+        statement += path[i].classPropertyName();
+    }
+}
+
+// Column of the filtered property, qualified with the join alias for property paths
+static void appendFilterColumn(QString& statement,
+                               const QOrmFilterTerminalPredicate& predicate,
+                               const QString& qualifier)
+{
+    if (!predicate.path().empty())
+    {
+        appendJoinAlias(statement, predicate.path(), predicate.path().size());
+        statement += QLatin1Char('.');
+    }
+    else if (!qualifier.isEmpty())
+    {
+        statement += qualifier;
+        statement += QLatin1Char('.');
+    }
+
+    statement += predicate.propertyMapping()->tableFieldName();
+}
+
+// Name of the bound parameters of a predicate; unique across joined tables
+static QString filterParameterName(const QOrmFilterTerminalPredicate& predicate)
+{
+    if (predicate.path().empty())
+        return predicate.propertyMapping()->tableFieldName();
+
+    QString name;
+    appendJoinAlias(name, predicate.path(), predicate.path().size());
+    name += QLatin1Char('_');
+    name += predicate.propertyMapping()->tableFieldName();
+
+    return name;
+}
+
+static QLatin1String comparisonOperator(QOrm::Comparison comparison)
+{
+    switch (comparison)
+    {
+        case QOrm::Comparison::Less:
+            return QLatin1String("<");
+        case QOrm::Comparison::Equal:
+            return QLatin1String("=");
+        case QOrm::Comparison::Greater:
+            return QLatin1String(">");
+        case QOrm::Comparison::NotEqual:
+            return QLatin1String("<>");
+        case QOrm::Comparison::LessOrEqual:
+            return QLatin1String("<=");
+        case QOrm::Comparison::GreaterOrEqual:
+            return QLatin1String(">=");
+        case QOrm::Comparison::In:
+        case QOrm::Comparison::NotIn:
+            break;
+    }
+
+    Q_ORM_UNEXPECTED_STATE;
+}
+
+static void appendFromClause(QString& statement,
+                             const QOrmRelation& relation,
+                             QVariantMap& boundParameters)
+{
+    statement += QLatin1String("FROM ");
+
+    switch (relation.type())
+    {
+        case QOrm::RelationType::Mapping:
+            statement += relation.mapping()->tableName();
+            return;
+
+        case QOrm::RelationType::Query:
+            statement += QLatin1Char('(');
+            appendSelectStatement(statement, *relation.query(), boundParameters);
+            statement += QLatin1Char(')');
+            return;
+    }
+
+    Q_ORM_UNEXPECTED_STATE;
+}
+
+// Appends "WHERE <condition>"; the caller skips always true filters
+static void appendWhereClause(QString& statement,
+                              const QOrmFilter& filter,
+                              QVariantMap& boundParameters,
+                              const QString& qualifier)
+{
+    Q_ASSERT(!isAlwaysTrue(filter));
+
+    statement += QLatin1String("WHERE ");
+    appendCondition(statement, *filter.expression(), boundParameters, qualifier);
+}
+
+static void appendOrderClause(QString& statement,
+                              const std::vector<QOrmOrder>& order,
+                              const QString& qualifier)
+{
+    Q_ASSERT(!order.empty());
+
+    statement += QLatin1String("ORDER BY ");
+
+    for (auto it = std::cbegin(order); it != std::cend(order); ++it)
+    {
+        if (it != std::cbegin(order))
+            statement += QLatin1Char(',');
+
+        if (!qualifier.isEmpty())
+        {
+            statement += qualifier;
+            statement += QLatin1Char('.');
+        }
+
+        statement += it->mapping().tableFieldName();
+        statement += it->direction() == Qt::AscendingOrder ? QLatin1String(" ASC")
+                                                           : QLatin1String(" DESC");
+    }
+}
+
+// LEFT JOINs of the tables referenced by property paths in the filter expression, with the
+// filtered table named by qualifier. Each join is preceded by a space.
+static void appendJoinClause(QString& statement,
+                             const QOrmFilterExpression& expression,
+                             const QString& qualifier)
+{
+    QStringList aliases;
+
+    const auto predicates = QOrmPrivate::terminalPredicates(expression);
+
+    for (const QOrmFilterTerminalPredicate* predicate : predicates)
+    {
+        const std::vector<QOrmPropertyMapping>& path = predicate->path();
+
+        // Each prefix of the path is joined once; a LEFT JOIN keeps the rows with null references
+        // so that they can still match other operands of a disjunction
+        for (size_t i = 0; i < path.size(); ++i)
+        {
+            QString alias;
+            appendJoinAlias(alias, path, i + 1);
+
+            if (aliases.contains(alias))
+                continue;
+
+            const QOrmMetadata* referencedEntity = path[i].referencedEntity();
+            Q_ASSERT(referencedEntity != nullptr);
+            Q_ASSERT(referencedEntity->objectIdMapping() != nullptr);
+
+            statement += QLatin1String(" LEFT JOIN ");
+            statement += referencedEntity->tableName();
+            statement += QLatin1String(" AS ");
+            statement += alias;
+            statement += QLatin1String(" ON ");
+            statement += alias;
+            statement += QLatin1Char('.');
+            statement += referencedEntity->objectIdMapping()->tableFieldName();
+            statement += QLatin1String(" = ");
+
+            if (i == 0)
+                statement += qualifier;
+            else
+                appendJoinAlias(statement, path, i);
+
+            statement += QLatin1Char('.');
+            statement += path[i].tableFieldName();
+
+            aliases.push_back(std::move(alias));
+        }
+    }
+}
+
+static void appendInCondition(QString& statement,
+                              const QOrmFilterTerminalPredicate& predicate,
+                              QVariantMap& boundParameters,
+                              const QString& qualifier)
+{
+    const QOrmPropertyMapping* propertyMapping = predicate.propertyMapping();
+
+    if (predicate.value().userType() == qMetaTypeId<QOrmQueryParameter>())
+        qFatal("QtOrm: Query parameters cannot be used as IN lists");
+
+    QVariantList values = predicate.value().toList();
+
+    if (propertyMapping->isReference())
+    {
+        const QOrmMetadata* referencedEntity = propertyMapping->referencedEntity();
+        Q_ASSERT(referencedEntity != nullptr);
+
+        for (QVariant& value : values)
+        {
+            auto referencedInstance = value.value<QObject*>();
+            Q_ASSERT(referencedInstance != nullptr);
+
+            value = QOrmPrivate::objectIdPropertyValue(referencedInstance, *referencedEntity);
+        }
+    }
+
+    appendFilterColumn(statement, predicate, qualifier);
+    statement += predicate.comparison() == QOrm::Comparison::In ? QLatin1String(" IN (")
+                                                                : QLatin1String(" NOT IN (");
+
+    QString parameterName = filterParameterName(predicate);
+
+    // Large lists would exceed the limit of bound parameters and make every statement unique
+    if (values.size() > QOrmSqliteStatementGenerator::MaxInlineArraySize)
+    {
+        QString parameterKey = insertParameter(boundParameters,
+                                               QStringLiteral("qtorm_array_") % parameterName,
+                                               values);
+
+        statement += QLatin1String("SELECT value FROM ");
+        statement += QOrmSqliteStatementGenerator::arrayTableName(parameterKey);
+        statement += QLatin1Char(')');
+        return;
+    }
+
+    for (int i = 0; i < values.size(); ++i)
+    {
+        if (i > 0)
+            statement += QLatin1String(", ");
+
+        statement += insertParameter(boundParameters, parameterName, values[i]);
+    }
+
+    statement += QLatin1Char(')');
+}
+
+static void appendCondition(QString& statement,
+                            const QOrmFilterTerminalPredicate& predicate,
+                            QVariantMap& boundParameters,
+                            const QString& qualifier)
+{
+    Q_ASSERT(predicate.isResolved());
+
+    if (predicate.comparison() == QOrm::Comparison::In ||
+        predicate.comparison() == QOrm::Comparison::NotIn)
+    {
+        appendInCondition(statement, predicate, boundParameters, qualifier);
+        return;
+    }
+
+    QVariant value;
+
+    // placeholders are bound by the provider when the prepared statement is executed
+    if (predicate.value().userType() == qMetaTypeId<QOrmQueryParameter>())
+    {
+        value = predicate.value();
+    }
+    else if (predicate.propertyMapping()->isReference())
+    {
+        const QOrmMetadata* referencedEntity = predicate.propertyMapping()->referencedEntity();
+        Q_ASSERT(referencedEntity != nullptr);
+
+        auto referencedInstance = predicate.value().value<QObject*>();
+        Q_ASSERT(referencedInstance != nullptr);
+
+        value = QOrmPrivate::objectIdPropertyValue(referencedInstance, *referencedEntity);
+    }
+    else
+    {
+        value = predicate.value();
+    }
+
+    appendFilterColumn(statement, predicate, qualifier);
+    statement += QLatin1Char(' ');
+    statement += comparisonOperator(predicate.comparison());
+    statement += QLatin1Char(' ');
+    statement += insertParameter(boundParameters, filterParameterName(predicate), value);
+}
+
+static void appendCondition(QString& statement,
+                            const QOrmFilterBinaryPredicate& predicate,
+                            QVariantMap& boundParameters,
+                            const QString& qualifier)
+{
+    statement += QLatin1Char('(');
+    appendCondition(statement, predicate.lhs(), boundParameters, qualifier);
+
+    switch (predicate.logicalOperator())
+    {
+        case QOrm::BinaryLogicalOperator::Or:
+            statement += QLatin1String(") OR (");
+            break;
+        case QOrm::BinaryLogicalOperator::And:
+            statement += QLatin1String(") AND (");
+            break;
+    }
+
+    appendCondition(statement, predicate.rhs(), boundParameters, qualifier);
+    statement += QLatin1Char(')');
+}
+
+static void appendCondition(QString& statement,
+                            const QOrmFilterNaryPredicate& predicate,
+                            QVariantMap& boundParameters,
+                            const QString& qualifier)
+{
+    bool isConjunction = predicate.logicalOperator() == QOrm::BinaryLogicalOperator::And;
+
+    if (predicate.operands().isEmpty())
+    {
+        statement += isConjunction ? QLatin1Char('1') : QLatin1Char('0');
+        return;
+    }
+
+    QLatin1String separator = isConjunction ? QLatin1String(" AND ") : QLatin1String(" OR ");
+    bool isFirst = true;
+
+    for (const QOrmFilterExpression& operand : predicate.operands())
+    {
+        if (!isFirst)
+            statement += separator;
+
+        isFirst = false;
+
+        // only nested logical operators need parentheses, NOT already has them
+        bool isCompound = operand.type() == QOrm::FilterExpressionType::BinaryPredicate ||
+                          operand.type() == QOrm::FilterExpressionType::NaryPredicate;
+
+        if (isCompound)
+            statement += QLatin1Char('(');
+
+        appendCondition(statement, operand, boundParameters, qualifier);
+
+        if (isCompound)
+            statement += QLatin1Char(')');
+    }
+}
+
+static void appendCondition(QString& statement,
+                            const QOrmFilterUnaryPredicate& predicate,
+                            QVariantMap& boundParameters,
+                            const QString& qualifier)
+{
+    Q_ASSERT(predicate.logicalOperator() == QOrm::UnaryLogicalOperator::Not);
+
+    statement += QLatin1String("NOT (");
+    appendCondition(statement, predicate.rhs(), boundParameters, qualifier);
+    statement += QLatin1Char(')');
+}
+
+static void appendCondition(QString& statement,
+                            const QOrmFilterExpression& expression,
+                            QVariantMap& boundParameters,
+                            const QString& qualifier)
+{
+    switch (expression.type())
+    {
+        case QOrm::FilterExpressionType::TerminalPredicate:
+            Q_ASSERT(expression.terminalPredicate() != nullptr);
+            appendCondition(statement, *expression.terminalPredicate(), boundParameters, qualifier);
+            return;
+
+        case QOrm::FilterExpressionType::BinaryPredicate:
+            Q_ASSERT(expression.binaryPredicate() != nullptr);
+            appendCondition(statement, *expression.binaryPredicate(), boundParameters, qualifier);
+            return;
+
+        case QOrm::FilterExpressionType::UnaryPredicate:
+            Q_ASSERT(expression.unaryPredicate() != nullptr);
+            appendCondition(statement, *expression.unaryPredicate(), boundParameters, qualifier);
+            return;
+
+        case QOrm::FilterExpressionType::NaryPredicate:
+            Q_ASSERT(expression.naryPredicate() != nullptr);
+            appendCondition(statement, *expression.naryPredicate(), boundParameters, qualifier);
+            return;
+    }
+
+    Q_ORM_UNEXPECTED_STATE;
+}
+
+// Selects the given columns of the relation, or all of them; nested queries are expected to be
+// flattened already, see QOrmSqliteStatementGenerator::flattenedQuery()
+static void appendSelectStatement(QString& statement,
+                                  const QOrmQuery& query,
+                                  QVariantMap& boundParameters,
+                                  const std::vector<QOrmPropertyMapping>* columns)
+{
+    Q_ASSERT(query.operation() == QOrm::Operation::Read);
+
+    const QOrmRelation& relation = query.relation();
+    const QString& tableName = relation.type() == QOrm::RelationType::Mapping
+                                   ? relation.mapping()->tableName()
+                                   : relation.query()->projection()->tableName();
+
+    bool hasFilter = query.filter().has_value() && !isAlwaysTrue(*query.filter());
+    bool hasJoins = hasFilter && hasPropertyPaths(*query.filter()->expression());
+
+    // Columns of the filtered relation are qualified if joined tables may have the same ones
+    const QString qualifier = hasJoins ? tableName : QString{};
+
+    statement += QLatin1String("SELECT ");
+
+    if (columns == nullptr)
+    {
+        if (hasJoins)
+        {
+            statement += qualifier;
+            statement += QLatin1Char('.');
+        }
+
+        statement += QLatin1Char('*');
+    }
+    else
+    {
+        for (const QOrmPropertyMapping& column : *columns)
+        {
+            if (&column != &columns->front())
+                statement += QLatin1Char(',');
+
+            if (hasJoins)
+            {
+                statement += qualifier;
+                statement += QLatin1Char('.');
+            }
+
+            statement += column.tableFieldName();
+        }
+    }
+
+    statement += QLatin1Char(' ');
+    appendFromClause(statement, relation, boundParameters);
+
+    if (hasJoins)
+    {
+        if (relation.type() == QOrm::RelationType::Query)
+        {
+            statement += QLatin1String(" AS ");
+            statement += tableName;
+        }
+
+        appendJoinClause(statement, *query.filter()->expression(), qualifier);
+    }
+
+    if (hasFilter)
+    {
+        statement += QLatin1Char(' ');
+        appendWhereClause(statement, *query.filter(), boundParameters, qualifier);
+    }
+
+    if (!query.order().empty())
+    {
+        statement += QLatin1Char(' ');
+        appendOrderClause(statement, query.order(), qualifier);
+    }
+
+    // SQLite requires a LIMIT clause for OFFSET; a negative limit means no limit
+    if (query.limit().has_value() || query.offset().has_value())
+    {
+        statement += QLatin1String(" LIMIT ");
+        statement += QString::number(query.limit().value_or(-1));
+    }
+
+    if (query.offset().has_value())
+    {
+        statement += QLatin1String(" OFFSET ");
+        statement += QString::number(*query.offset());
+    }
+}
+
+// Renders an INSERT of the columns with rowCount rows of values. The value of a column in a row
+// is returned by valueOf(row, column, propertyMapping), the column being the position in
+// columnIndexes. The placeholders are suffixed with the row number.
+template<typename ValueOf>
+static void appendMultiRowInsert(QString& statement,
+                                 const QOrmMetadataPrivate& metadata,
+                                 const std::vector<int>& columnIndexes,
+                                 int rowCount,
+                                 ValueOf valueOf,
+                                 QVariantMap& boundParameters)
+{
+    statement += QLatin1String("INSERT INTO ");
+    statement += metadata.m_tableName;
+    statement += QLatin1Char('(');
+
+    for (int index : columnIndexes)
+    {
+        if (index != columnIndexes.front())
+            statement += QLatin1Char(',');
+
+        statement += metadata.m_propertyMappings[static_cast<size_t>(index)].tableFieldName();
+    }
+
+    statement += QLatin1String(") VALUES");
+
+    for (int row = 0; row < rowCount; ++row)
+    {
+        statement += row == 0 ? QLatin1String("(") : QLatin1String(",(");
+
+        for (int column = 0; column < static_cast<int>(columnIndexes.size()); ++column)
+        {
+            const QOrmPropertyMapping& propertyMapping =
+                metadata.m_propertyMappings[static_cast<size_t>(columnIndexes[column])];
+
+            if (column > 0)
+                statement += QLatin1Char(',');
+
+            statement += insertParameter(boundParameters,
+                                         propertyMapping.tableFieldName() % QLatin1Char('_') %
+                                             QString::number(row),
+                                         valueOf(row, column, propertyMapping));
+        }
+
+        statement += QLatin1Char(')');
+    }
+}
+
+// Reads the values of a multi-row INSERT from the entity instances
+template<typename EntityInstances>
+static auto entityInstanceValues(const EntityInstances& entityInstances)
+{
+    return [first = std::begin(entityInstances)](int row,
+                                                 int /*column*/,
+                                                 const QOrmPropertyMapping& propertyMapping) {
+        return propertyValueForQuery(*(first + row), propertyMapping);
+    };
+}
+
+// Renders an INSERT of all columns including the object ID that updates the row with the same
+// object ID if it exists
+template<typename EntityInstances>
+static void appendUpsertStatement(QString& statement,
+                                  const QOrmMetadata& relation,
+                                  const EntityInstances& entityInstances,
+                                  QVariantMap& boundParameters)
+{
+    if (relation.objectIdMapping() == nullptr)
+        qFatal("QtORM: Unable to upsert entity without object ID property");
+
+    const QOrmMetadataPrivate& metadata = *QOrmMetadataPrivate::get(relation);
+
+    // the update statement lists the other columns and the object ID last
+    appendMultiRowInsert(statement,
+                         metadata,
+                         metadata.m_updateMappingIndexes,
+                         static_cast<int>(std::size(entityInstances)),
+                         entityInstanceValues(entityInstances),
+                         boundParameters);
+
+    statement += QLatin1String(" ON CONFLICT(");
+    statement += relation.objectIdMapping()->tableFieldName();
+    statement += QLatin1Char(')');
+
+    if (metadata.m_updateMappingIndexes.size() == 1)
+    {
+        statement += QLatin1String(" DO NOTHING");
+        return;
+    }
+
+    statement += QLatin1String(" DO UPDATE SET ");
+
+    for (int index : metadata.m_updateMappingIndexes)
+    {
+        const QOrmPropertyMapping& propertyMapping =
+            metadata.m_propertyMappings[static_cast<size_t>(index)];
+
+        if (propertyMapping.isObjectId())
+            continue;
+
+        if (index != metadata.m_updateMappingIndexes.front())
+            statement += QLatin1Char(',');
+
+        statement += propertyMapping.tableFieldName();
+        statement += QLatin1String(" = excluded.");
+        statement += propertyMapping.tableFieldName();
+    }
+}
+
 std::pair<QString, QVariantMap> QOrmSqliteStatementGenerator::generate(const QOrmQuery& query)
 {
     QVariantMap boundParameters;
     QString statement = generate(query, boundParameters);
 
-    return std::make_pair(statement, boundParameters);
+    return std::make_pair(std::move(statement), std::move(boundParameters));
 }
 
 QString QOrmSqliteStatementGenerator::generate(const QOrmQuery& query, QVariantMap& boundParameters)
@@ -90,6 +715,11 @@ QString QOrmSqliteStatementGenerator::generate(const QOrmQuery& query, QVariantM
                                            query.entityInstance(),
                                            boundParameters);
 
+        case QOrm::Operation::Merge:
+            return generateUpsertStatement(*query.relation().mapping(),
+                                           query.entityInstance(),
+                                           boundParameters);
+
         case QOrm::Operation::Read:
             return generateSelectStatement(query, boundParameters);
 
@@ -120,245 +750,415 @@ QString QOrmSqliteStatementGenerator::generateInsertStatement(const QOrmMetadata
                                                               const QObject* entityInstance,
                                                               QVariantMap& boundParameters)
 {
-    QStringList fieldsList;
-    QStringList valuesList;
+    const QOrmMetadataPrivate& metadata = *QOrmMetadataPrivate::get(relation);
 
-    for (const QOrmPropertyMapping& propertyMapping : relation.propertyMappings())
+    // Without other bound parameters the placeholders are the column names, and the statement
+    // rendered with the metadata is used as is
+    if (boundParameters.isEmpty())
     {
-        if (propertyMapping.isAutogenerated() || propertyMapping.isTransient())
-            continue;
-
-        QVariant propertyValue = propertyValueForQuery(entityInstance, propertyMapping);
+        for (int index : metadata.m_insertMappingIndexes)
+        {
+            const QOrmPropertyMapping& propertyMapping =
+                metadata.m_propertyMappings[static_cast<size_t>(index)];
 
-        QString valueStr =
-            insertParameter(boundParameters, propertyMapping.tableFieldName(), propertyValue);
+            boundParameters.insert(QLatin1Char(':') % propertyMapping.tableFieldName(),
+                                   propertyValueForQuery(entityInstance, propertyMapping));
+        }
 
-        fieldsList.push_back(propertyMapping.tableFieldName());
-        valuesList.push_back(valueStr);
+        return metadata.m_insertStatement;
     }
 
-    QString fieldsStr = fieldsList.join(',');
-    QString valuesStr = valuesList.join(',');
-
-    QString statement = QStringLiteral("INSERT INTO %1(%2) VALUES(%3)")
-                            .arg(relation.tableName(), fieldsStr, valuesStr);
+    QString statement;
+    statement.reserve(metadata.m_insertStatement.size() + InitialStatementCapacity);
 
-    return statement;
-}
+    QString values;
+    values.reserve(InitialStatementCapacity);
 
-QString QOrmSqliteStatementGenerator::generateUpdateStatement(const QOrmMetadata& relation,
-                                                              const QObject* entityInstance,
-                                                              QVariantMap& boundParameters)
-{
-    if (relation.objectIdMapping() == nullptr)
-        qFatal("QtORM: Unable to update entity without object ID property");
-
-    QStringList setList;
+    statement += QLatin1String("INSERT INTO ");
+    statement += metadata.m_tableName;
+    statement += QLatin1Char('(');
 
-    for (const QOrmPropertyMapping& propertyMapping : relation.propertyMappings())
+    for (int index : metadata.m_insertMappingIndexes)
     {
-        if (propertyMapping.isTransient() || propertyMapping.isObjectId())
-            continue;
+        const QOrmPropertyMapping& propertyMapping =
+            metadata.m_propertyMappings[static_cast<size_t>(index)];
 
-        QVariant propertyValue = propertyValueForQuery(entityInstance, propertyMapping);
+        if (!values.isEmpty())
+        {
+            statement += QLatin1Char(',');
+            values += QLatin1Char(',');
+        }
 
-        QString parameterName =
-            insertParameter(boundParameters, propertyMapping.tableFieldName(), propertyValue);
-        setList.push_back(QString{"%1 = %2"}.arg(propertyMapping.tableFieldName(), parameterName));
+        statement += propertyMapping.tableFieldName();
+        values += insertParameter(boundParameters,
+                                  propertyMapping.tableFieldName(),
+                                  propertyValueForQuery(entityInstance, propertyMapping));
     }
 
-    QVariant objectId = QOrmPrivate::objectIdPropertyValue(entityInstance, relation);
+    statement += QLatin1String(") VALUES(");
+    statement += values;
+    statement += QLatin1Char(')');
 
-    QString whereClause =
-        generateWhereClause(QOrmFilter{*relation.objectIdMapping() == objectId}, boundParameters);
+    return statement;
+}
+
+QString QOrmSqliteStatementGenerator::generateInsertStatement(
+    const QOrmMetadata& relation,
+    const QVector<QObject*>& entityInstances,
+    QVariantMap& boundParameters)
+{
+    Q_ASSERT(!entityInstances.isEmpty());
+    Q_ASSERT(entityInstances.size() <= maxBatchSize(QOrm::Operation::Create, relation));
 
-    QStringList parts = {"UPDATE", relation.tableName(), "SET", setList.join(','), whereClause};
+    const QOrmMetadataPrivate& metadata = *QOrmMetadataPrivate::get(relation);
 
-    return parts.join(QChar(' '));
+    QString statement;
+    statement.reserve(metadata.m_insertStatement.size() * 2 + InitialStatementCapacity);
+
+    appendMultiRowInsert(statement,
+                         metadata,
+                         metadata.m_insertMappingIndexes,
+                         entityInstances.size(),
+                         entityInstanceValues(entityInstances),
+                         boundParameters);
+
+    return statement;
 }
 
-QString QOrmSqliteStatementGenerator::generateSelectStatement(const QOrmQuery& query,
+QString QOrmSqliteStatementGenerator::generateInsertStatement(const QOrmMetadata& relation,
+                                                              const QOrmRowSet& rowSet,
+                                                              int firstRow,
+                                                              int rowCount,
                                                               QVariantMap& boundParameters)
 {
-    Q_ASSERT(query.operation() == QOrm::Operation::Read);
+    Q_ASSERT(rowCount > 0 && firstRow + rowCount <= rowSet.rowCount());
+    Q_ASSERT(rowCount <= maxBatchSize(QOrm::Operation::Create, relation));
 
-    QStringList parts = {"SELECT *", generateFromClause(query.relation(), boundParameters)};
+    const QOrmMetadataPrivate& metadata = *QOrmMetadataPrivate::get(relation);
 
-    if (query.filter().has_value())
-        parts += generateWhereClause(*query.filter(), boundParameters);
+    Q_ASSERT(rowSet.columnCount() == static_cast<int>(metadata.m_insertMappingIndexes.size()));
+
+    QString statement;
+    statement.reserve(metadata.m_insertStatement.size() * 2 + InitialStatementCapacity);
 
-    parts += generateOrderClause(query.order());
+    appendMultiRowInsert(
+        statement,
+        metadata,
+        metadata.m_insertMappingIndexes,
+        rowCount,
+        [&rowSet, firstRow](int row, int column, const QOrmPropertyMapping& /*propertyMapping*/) {
+            return rowSet.value(firstRow + row, column);
+        },
+        boundParameters);
 
-    return parts.join(QChar{' '});
+    return statement;
 }
 
-QString QOrmSqliteStatementGenerator::generateDeleteStatement(const QOrmMetadata& relation,
-                                                              const QOrmFilter& filter,
+QString QOrmSqliteStatementGenerator::generateUpsertStatement(const QOrmMetadata& relation,
+                                                              const QObject* entityInstance,
                                                               QVariantMap& boundParameters)
 {
-    QStringList parts = {"DELETE",
-                         generateFromClause(QOrmRelation{relation}, boundParameters),
-                         generateWhereClause(filter, boundParameters)};
+    QString statement;
+    statement.reserve(InitialStatementCapacity);
 
-    return parts.join(QChar{' '});
+    appendUpsertStatement(statement,
+                          relation,
+                          std::initializer_list<const QObject*>{entityInstance},
+                          boundParameters);
+
+    return statement;
 }
 
-QString QOrmSqliteStatementGenerator::generateDeleteStatement(const QOrmMetadata& relation,
-                                                              const QObject* instance,
-                                                              QVariantMap& boundParameters)
+QString QOrmSqliteStatementGenerator::generateUpsertStatement(
+    const QOrmMetadata& relation,
+    const QVector<QObject*>& entityInstances,
+    QVariantMap& boundParameters)
 {
-    Q_ASSERT(relation.objectIdMapping() != nullptr);
+    Q_ASSERT(!entityInstances.isEmpty());
+    Q_ASSERT(entityInstances.size() <= maxBatchSize(QOrm::Operation::Merge, relation));
+
+    QString statement;
+    statement.reserve(InitialStatementCapacity * 2);
 
-    QVariant objectId = QOrmPrivate::objectIdPropertyValue(instance, relation);
+    appendUpsertStatement(statement, relation, entityInstances, boundParameters);
 
-    return generateDeleteStatement(relation,
-                                   QOrmFilter{*relation.objectIdMapping() == objectId},
-                                   boundParameters);
+    return statement;
 }
 
-QString QOrmSqliteStatementGenerator::generateFromClause(const QOrmRelation& relation,
-                                                         QVariantMap& boundParameters)
+int QOrmSqliteStatementGenerator::maxBatchSize(QOrm::Operation operation,
+                                               const QOrmMetadata& relation)
 {
-    switch (relation.type())
+    const QOrmMetadataPrivate& metadata = *QOrmMetadataPrivate::get(relation);
+
+    switch (operation)
     {
-        case QOrm::RelationType::Mapping:
-            return QString{"FROM %1"}.arg(relation.mapping()->tableName());
+        case QOrm::Operation::Create:
+            return MaxBoundParameters /
+                   std::max(1, static_cast<int>(metadata.m_insertMappingIndexes.size()));
 
-        case QOrm::RelationType::Query:
-            Q_ASSERT(relation.query()->operation() == QOrm::Operation::Read);
+        case QOrm::Operation::Merge:
+            return MaxBoundParameters /
+                   std::max(1, static_cast<int>(metadata.m_updateMappingIndexes.size()));
 
-            return QString{"FROM (%1)"}.arg(generate(*relation.query(), boundParameters));
+        default:
+            Q_ORM_UNEXPECTED_STATE;
     }
-
-    Q_ORM_UNEXPECTED_STATE;
 }
 
-QString QOrmSqliteStatementGenerator::generateWhereClause(const QOrmFilter& filter,
-                                                          QVariantMap& boundParameters)
+QString QOrmSqliteStatementGenerator::generateUpdateStatement(const QOrmMetadata& relation,
+                                                              const QObject* entityInstance,
+                                                              QVariantMap& boundParameters)
 {
-    QString whereClause;
+    if (relation.objectIdMapping() == nullptr)
+        qFatal("QtORM: Unable to update entity without object ID property");
+
+    const QOrmMetadataPrivate& metadata = *QOrmMetadataPrivate::get(relation);
 
-    if (filter.type() == QOrm::FilterType::Expression)
+    // The object ID is the last placeholder of the cached statement, see initializeStatements()
+    if (boundParameters.isEmpty())
     {
-        Q_ASSERT(filter.expression() != nullptr);
+        for (int index : metadata.m_updateMappingIndexes)
+        {
+            const QOrmPropertyMapping& propertyMapping =
+                metadata.m_propertyMappings[static_cast<size_t>(index)];
 
-        whereClause = generateCondition(*filter.expression(), boundParameters);
+            boundParameters.insert(QLatin1Char(':') % propertyMapping.tableFieldName(),
+                                   propertyValueForQuery(entityInstance, propertyMapping));
+        }
 
-        if (!whereClause.isEmpty())
-            whereClause = "WHERE " + whereClause;
+        return metadata.m_updateStatement;
     }
 
-    return whereClause;
-}
+    QString statement;
+    statement.reserve(metadata.m_updateStatement.size() + InitialStatementCapacity);
 
-QString QOrmSqliteStatementGenerator::generateOrderClause(const std::vector<QOrmOrder>& order)
-{
-    QStringList parts;
+    statement += QLatin1String("UPDATE ");
+    statement += metadata.m_tableName;
+    statement += QLatin1String(" SET ");
 
-    for (const QOrmOrder& element : order)
+    for (int index : metadata.m_updateMappingIndexes)
     {
-        parts += element.mapping().tableFieldName() % (element.direction() == Qt::AscendingOrder
-                                                           ? QStringLiteral(" ASC")
-                                                           : QStringLiteral(" DESC"));
+        const QOrmPropertyMapping& propertyMapping =
+            metadata.m_propertyMappings[static_cast<size_t>(index)];
+
+        if (propertyMapping.isObjectId())
+            statement += QLatin1String(" WHERE ");
+        else if (index != metadata.m_updateMappingIndexes.front())
+            statement += QLatin1Char(',');
+
+        statement += propertyMapping.tableFieldName();
+        statement += QLatin1String(" = ");
+        statement += insertParameter(boundParameters,
+                                     propertyMapping.tableFieldName(),
+                                     propertyValueForQuery(entityInstance, propertyMapping));
     }
 
-    return parts.empty() ? QString{} : QStringLiteral("ORDER BY ") % parts.join(',');
+    return statement;
 }
 
-QString QOrmSqliteStatementGenerator::generateCondition(const QOrmFilterExpression& expression,
-                                                        QVariantMap& boundParameters)
+QString QOrmSqliteStatementGenerator::generateSelectStatement(const QOrmQuery& query,
+                                                              QVariantMap& boundParameters)
 {
-    switch (expression.type())
-    {
-        case QOrm::FilterExpressionType::TerminalPredicate:
-            Q_ASSERT(expression.terminalPredicate() != nullptr);
-            return generateCondition(*expression.terminalPredicate(), boundParameters);
+    QString statement;
+    statement.reserve(InitialStatementCapacity);
 
-        case QOrm::FilterExpressionType::BinaryPredicate:
-            Q_ASSERT(expression.binaryPredicate() != nullptr);
-            return generateCondition(*expression.binaryPredicate(), boundParameters);
+    // Deeply nested subqueries are hard on the SQLite query planner
+    appendSelectStatement(statement, flattenedQuery(query), boundParameters);
 
-        case QOrm::FilterExpressionType::UnaryPredicate:
-            Q_ASSERT(expression.unaryPredicate() != nullptr);
-            return generateCondition(*expression.unaryPredicate(), boundParameters);
-    }
+    return statement;
+}
 
-    Q_ORM_UNEXPECTED_STATE;
+QString QOrmSqliteStatementGenerator::generateSelectStatement(
+    const QOrmQuery& query,
+    const std::vector<QOrmPropertyMapping>& columns,
+    QVariantMap& boundParameters)
+{
+    Q_ASSERT(!columns.empty());
+
+    QString statement;
+    statement.reserve(InitialStatementCapacity);
+
+    // Deeply nested subqueries are hard on the SQLite query planner
+    appendSelectStatement(statement, flattenedQuery(query), boundParameters, &columns);
+
+    return statement;
 }
 
-QString
-QOrmSqliteStatementGenerator::generateCondition(const QOrmFilterTerminalPredicate& predicate,
-                                                QVariantMap& boundParameters)
+static bool isMergeableQuery(const QOrmQuery& query, const QOrmQuery& nested)
 {
-    Q_ASSERT(predicate.isResolved());
+    return nested.operation() == QOrm::Operation::Read && !nested.limit().has_value() &&
+           !nested.offset().has_value() && nested.invokableFilters().empty() &&
+           query.projection().has_value() && nested.projection().has_value() &&
+           query.projection()->className() == nested.projection()->className() &&
+           (!query.filter().has_value() ||
+            query.filter()->type() == QOrm::FilterType::Expression) &&
+           (!nested.filter().has_value() ||
+            nested.filter()->type() == QOrm::FilterType::Expression);
+}
 
-    static const QHash<QOrm::Comparison, QString> comparisonOps = {
-        {QOrm::Comparison::Less, "<"},
-        {QOrm::Comparison::Equal, "="},
-        {QOrm::Comparison::Greater, ">"},
-        {QOrm::Comparison::NotEqual, "<>"},
-        {QOrm::Comparison::LessOrEqual, "<="},
-        {QOrm::Comparison::GreaterOrEqual, ">="}};
+QOrmQuery QOrmSqliteStatementGenerator::flattenedQuery(const QOrmQuery& query)
+{
+    if (query.operation() != QOrm::Operation::Read ||
+        query.relation().type() != QOrm::RelationType::Query)
+    {
+        return query;
+    }
 
-    Q_ASSERT(comparisonOps.contains(predicate.comparison()));
+    // Walks down the nested queries once, collecting the filters of the merged ones innermost
+    // first; the combined filter is resolved once against the innermost merged relation.
+    QVector<QOrmFilterExpression> filterExpressions;
+    std::optional<QOrmFilter> filter = query.filter();
+    std::vector<QOrmOrder> order = query.order();
+    const QOrmQuery* merged = &query;
 
-    QVariant value;
+    if (query.filter().has_value())
+        filterExpressions.push_back(*query.filter()->expression());
 
-    if (predicate.propertyMapping()->isReference())
+    while (merged->relation().type() == QOrm::RelationType::Query &&
+           isMergeableQuery(*merged, *merged->relation().query()))
     {
-        const QOrmMetadata* referencedEntity = predicate.propertyMapping()->referencedEntity();
-        Q_ASSERT(referencedEntity != nullptr);
+        merged = merged->relation().query();
 
-        auto referencedInstance = predicate.value().value<QObject*>();
-        Q_ASSERT(referencedInstance != nullptr);
+        if (merged->filter().has_value())
+        {
+            filterExpressions.prepend(*merged->filter()->expression());
+            filter = merged->filter();
+        }
 
-        value = QOrmPrivate::objectIdPropertyValue(referencedInstance, *referencedEntity);
+        for (const QOrmOrder& nestedElement : merged->order())
+        {
+            bool isOrdered = std::any_of(std::cbegin(order),
+                                         std::cend(order),
+                                         [&nestedElement](const QOrmOrder& element) {
+                                             return element.mapping().tableFieldName() ==
+                                                    nestedElement.mapping().tableFieldName();
+                                         });
+
+            if (!isOrdered)
+                order.push_back(nestedElement);
+        }
     }
-    else
+
+    if (merged == &query)
     {
-        value = predicate.value();
+        return QOrmQuery{query.operation(),
+                         QOrmRelation{flattenedQuery(*query.relation().query())},
+                         query.projection(),
+                         query.filter(),
+                         query.order(),
+                         query.flags(),
+                         query.limit(),
+                         query.offset()};
     }
 
-    QString parameterKey =
-        insertParameter(boundParameters, predicate.propertyMapping()->tableFieldName(), value);
-
-    QString statement = QString{"%1 %2 %3"}.arg(predicate.propertyMapping()->tableFieldName(),
-                                                comparisonOps[predicate.comparison()],
-                                                parameterKey);
+    // a single filter is kept as is
+    if (filterExpressions.size() > 1)
+    {
+        filter = QOrmFilter{QOrmPrivate::resolvedFilterExpression(
+            merged->relation(),
+            QOrmFilterNaryPredicate{QOrm::BinaryLogicalOperator::And, filterExpressions})};
+    }
 
-    return statement;
+    // The innermost merged query may still read from a query that cannot be merged
+    QOrmRelation relation = merged->relation().type() == QOrm::RelationType::Query
+                                ? QOrmRelation{flattenedQuery(*merged->relation().query())}
+                                : merged->relation();
+
+    return QOrmQuery{query.operation(),
+                     relation,
+                     query.projection(),
+                     filter,
+                     order,
+                     query.flags(),
+                     query.limit(),
+                     query.offset()};
 }
 
-QString QOrmSqliteStatementGenerator::generateCondition(const QOrmFilterBinaryPredicate& predicate,
-                                                        QVariantMap& boundParameters)
+QString QOrmSqliteStatementGenerator::generateDeleteStatement(const QOrmMetadata& relation,
+                                                              const QOrmFilter& filter,
+                                                              QVariantMap& boundParameters)
 {
-    QString lhsExpr = generateCondition(predicate.lhs(), boundParameters);
-    QString rhsExpr = generateCondition(predicate.rhs(), boundParameters);
+    QString statement;
+    statement.reserve(InitialStatementCapacity);
 
-    QString op;
+    statement += QLatin1String("DELETE FROM ");
+    statement += relation.tableName();
 
-    switch (predicate.logicalOperator())
+    if (isAlwaysTrue(filter))
+        return statement;
+
+    statement += QLatin1Char(' ');
+
+    if (!hasPropertyPaths(*filter.expression()))
     {
-        case QOrm::BinaryLogicalOperator::Or:
-            op = "OR";
-            break;
-        case QOrm::BinaryLogicalOperator::And:
-            op = "AND";
-            break;
+        appendWhereClause(statement, filter, boundParameters, QString{});
+        return statement;
     }
 
-    Q_ASSERT(!op.isEmpty());
+    // SQLite does not support joins in DELETE; select the object IDs to delete instead
+    Q_ASSERT(relation.objectIdMapping() != nullptr);
+
+    statement += QLatin1String("WHERE ");
+    statement += relation.objectIdMapping()->tableFieldName();
+    statement += QLatin1String(" IN (SELECT ");
+    statement += relation.tableName();
+    statement += QLatin1Char('.');
+    statement += relation.objectIdMapping()->tableFieldName();
+    statement += QLatin1String(" FROM ");
+    statement += relation.tableName();
+    appendJoinClause(statement, *filter.expression(), relation.tableName());
+    statement += QLatin1Char(' ');
+    appendWhereClause(statement, filter, boundParameters, relation.tableName());
+    statement += QLatin1Char(')');
 
-    return QString{"(%1) %2 (%3)"}.arg(lhsExpr, op, rhsExpr);
+    return statement;
 }
 
-QString QOrmSqliteStatementGenerator::generateCondition(const QOrmFilterUnaryPredicate& predicate,
-                                                        QVariantMap& boundParameters)
+QString QOrmSqliteStatementGenerator::generateDeleteStatement(const QOrmMetadata& relation,
+                                                              const QObject* instance,
+                                                              QVariantMap& boundParameters)
 {
-    QString rhsExpr = generateCondition(predicate.rhs(), boundParameters);
-    Q_ASSERT(predicate.logicalOperator() == QOrm::UnaryLogicalOperator::Not);
+    Q_ASSERT(relation.objectIdMapping() != nullptr);
+
+    const QString& objectIdColumn = relation.objectIdMapping()->tableFieldName();
+
+    QString statement;
+    statement.reserve(InitialStatementCapacity);
+
+    statement += QLatin1String("DELETE FROM ");
+    statement += relation.tableName();
+    statement += QLatin1String(" WHERE ");
+    statement += objectIdColumn;
+    statement += QLatin1String(" = ");
+    statement += insertParameter(boundParameters,
+                                 objectIdColumn,
+                                 QOrmPrivate::objectIdPropertyValue(instance, relation));
+
+    return statement;
+}
+
+QString QOrmSqliteStatementGenerator::generateWhereClause(const QOrmFilter& filter,
+                                                          QVariantMap& boundParameters,
+                                                          const QString& qualifier)
+{
+    QString whereClause;
+
+    if (!isAlwaysTrue(filter))
+        appendWhereClause(whereClause, filter, boundParameters, qualifier);
+
+    return whereClause;
+}
+
+bool QOrmSqliteStatementGenerator::isArrayParameter(const QString& parameterKey)
+{
+    return parameterKey.startsWith(QLatin1String(":qtorm_array_"));
+}
+
+QString QOrmSqliteStatementGenerator::arrayTableName(const QString& parameterKey)
+{
+    Q_ASSERT(isArrayParameter(parameterKey));
 
-    return QString{"NOT (%1)"}.arg(rhsExpr);
+    return QStringLiteral("temp.") % parameterKey.midRef(1);
 }
 
 QString QOrmSqliteStatementGenerator::generateCreateTableStatement(const QOrmMetadata& entity)
@@ -26,6 +26,7 @@
 
 #include <QtCore/qstring.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 #include <QtCore/qshareddata.h>
 
 #include <utility>
@@ -34,15 +35,10 @@
 QT_BEGIN_NAMESPACE
 
 class QOrmFilter;
-class QOrmFilterBinaryPredicate;
-class QOrmFilterExpression;
-class QOrmFilterTerminalPredicate;
-class QOrmFilterUnaryPredicate;
 class QOrmMetadata;
-class QOrmOrder;
 class QOrmPropertyMapping;
 class QOrmQuery;
-class QOrmRelation;
+class QOrmRowSet;
 
 class Q_ORM_EXPORT QOrmSqliteStatementGenerator
 {    
@@ -58,6 +54,41 @@ public:
                                            const QObject* instance,
                                            QVariantMap& boundParameters);
 
+    // Renders a single INSERT with a row of values per entity instance
+    Q_REQUIRED_RESULT
+    static QString generateInsertStatement(const QOrmMetadata& relation,
+                                           const QVector<QObject*>& instances,
+                                           QVariantMap& boundParameters);
+
+    // Renders a single INSERT of rowCount rows of a row set starting at firstRow. The row set has
+    // the columns of the INSERT statement of the entity, see QOrmSession::insertValues().
+    Q_REQUIRED_RESULT
+    static QString generateInsertStatement(const QOrmMetadata& relation,
+                                           const QOrmRowSet& rowSet,
+                                           int firstRow,
+                                           int rowCount,
+                                           QVariantMap& boundParameters);
+
+    // Renders an INSERT of all columns including the object ID with an ON CONFLICT clause that
+    // updates the existing row with the same object ID instead
+    Q_REQUIRED_RESULT
+    static QString generateUpsertStatement(const QOrmMetadata& relation,
+                                           const QObject* instance,
+                                           QVariantMap& boundParameters);
+
+    Q_REQUIRED_RESULT
+    static QString generateUpsertStatement(const QOrmMetadata& relation,
+                                           const QVector<QObject*>& instances,
+                                           QVariantMap& boundParameters);
+
+    // Number of rows a multi-row INSERT or UPSERT of the entity can have within
+    // MaxBoundParameters
+    Q_REQUIRED_RESULT
+    static int maxBatchSize(QOrm::Operation operation, const QOrmMetadata& relation);
+
+    // Default SQLITE_MAX_VARIABLE_NUMBER of SQLite before 3.32
+    static constexpr int MaxBoundParameters = 999;
+
     Q_REQUIRED_RESULT
     static QString generateUpdateStatement(const QOrmMetadata& relation,
                                            const QObject* instance,
@@ -66,6 +97,18 @@ public:
     Q_REQUIRED_RESULT
     static QString generateSelectStatement(const QOrmQuery& query, QVariantMap& boundParameters);
 
+    // Selects only the columns of the property mappings, in their order
+    Q_REQUIRED_RESULT
+    static QString generateSelectStatement(const QOrmQuery& query,
+                                           const std::vector<QOrmPropertyMapping>& columns,
+                                           QVariantMap& boundParameters);
+
+    // Merges a read query into the nested read query of its relation if both have the same
+    // projection and the nested one has no limit or offset: the filters are combined with AND,
+    // and the nested order breaks the ties of the outer one. Applied recursively.
+    Q_REQUIRED_RESULT
+    static QOrmQuery flattenedQuery(const QOrmQuery& query);
+
     Q_REQUIRED_RESULT
     static QString generateDeleteStatement(const QOrmMetadata& relation,
                                            const QOrmFilter& filter,
@@ -77,26 +120,21 @@ public:
                                            QVariantMap& boundParameters);
 
     Q_REQUIRED_RESULT
-    static QString generateFromClause(const QOrmRelation& relation, QVariantMap& boundParameters);
+    static QString generateWhereClause(const QOrmFilter& filter,
+                                       QVariantMap& boundParameters,
+                                       const QString& qualifier = QString{});
 
-    Q_REQUIRED_RESULT
-    static QString generateWhereClause(const QOrmFilter& filter, QVariantMap& boundParameters);
+    // Lists longer than this are bound as a single array parameter, see isArrayParameter()
+    static constexpr int MaxInlineArraySize = 100;
 
+    // An array parameter is bound by filling the temporary table named by arrayTableName()
+    // with its QVariantList value before the statement is prepared; the table is dropped once
+    // the statement is done.
     Q_REQUIRED_RESULT
-    static QString generateOrderClause(const std::vector<QOrmOrder>& order);
+    static bool isArrayParameter(const QString& parameterKey);
 
     Q_REQUIRED_RESULT
-    static QString generateCondition(const QOrmFilterExpression& expression,
-                                     QVariantMap& boundParameters);
-    Q_REQUIRED_RESULT
-    static QString generateCondition(const QOrmFilterTerminalPredicate& predicate,
-                                     QVariantMap& boundParameters);
-    Q_REQUIRED_RESULT
-    static QString generateCondition(const QOrmFilterBinaryPredicate& predicate,
-                                     QVariantMap& boundParameters);
-    Q_REQUIRED_RESULT
-    static QString generateCondition(const QOrmFilterUnaryPredicate& predicate,
-                                     QVariantMap& boundParameters);
+    static QString arrayTableName(const QString& parameterKey);
 
     Q_REQUIRED_RESULT
     static QString generateCreateTableStatement(const QOrmMetadata& entity);
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qormtracer.h"
+
+#include "qormglobal_p.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+
+#include <chrono>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* category;
+        const char* name;
+        qint64 startTimestamp;
+        qint64 duration;
+        int threadId;
+        QString detail;
+    };
+
+    qint64 steadyClockNsecs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    struct TracerState
+    {
+        QMutex mutex;
+        // steady clock time of start(), read without the mutex by the tracing threads
+        std::atomic<qint64> epoch{0};
+        QFile file;
+        std::vector<TraceEvent> events;
+        // small sequential numbers are easier to read in the trace viewer than thread handles
+        QHash<Qt::HANDLE, int> threadIds;
+    };
+
+    Q_GLOBAL_STATIC(TracerState, tracerState)
+} // namespace
+
+std::atomic<bool> QOrmTracer::s_enabled{false};
+std::atomic<quint64> QOrmTracer::s_session{0};
+
+bool QOrmTracer::start(const QString& fileName)
+{
+    TracerState* state = tracerState();
+    QMutexLocker locker{&state->mutex};
+
+    if (isEnabled())
+    {
+        qCWarning(qtorm) << "Tracing is already active, writing to" << state->file.fileName();
+        return false;
+    }
+
+    state->file.setFileName(fileName);
+
+    if (!state->file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        qCWarning(qtorm) << "Unable to open the trace file" << fileName << ":"
+                         << state->file.errorString();
+        return false;
+    }
+
+    state->events.clear();
+    state->threadIds.clear();
+    state->epoch.store(steadyClockNsecs(), std::memory_order_relaxed);
+    s_session.fetch_add(1, std::memory_order_release);
+    s_enabled.store(true, std::memory_order_release);
+
+    return true;
+}
+
+bool QOrmTracer::stop()
+{
+    TracerState* state = tracerState();
+    QMutexLocker locker{&state->mutex};
+
+    if (!isEnabled())
+        return false;
+
+    s_enabled.store(false, std::memory_order_release);
+
+    qint64 processId = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+
+    for (const TraceEvent& event : state->events)
+    {
+        QJsonObject traceEvent{{"name", QLatin1String{event.name}},
+                               {"cat", QLatin1String{event.category}},
+                               {"ph", "X"},
+                               {"ts", event.startTimestamp / 1000.0},
+                               {"dur", event.duration / 1000.0},
+                               {"pid", processId},
+                               {"tid", event.threadId}};
+
+        if (!event.detail.isEmpty())
+            traceEvent.insert("args", QJsonObject{{"detail", event.detail}});
+
+        traceEvents.append(traceEvent);
+    }
+
+    state->events.clear();
+    state->threadIds.clear();
+
+    QJsonObject trace{{"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}};
+    bool isWritten = state->file.write(QJsonDocument{trace}.toJson(QJsonDocument::Compact)) >= 0;
+
+    if (!isWritten)
+    {
+        qCWarning(qtorm) << "Unable to write the trace file" << state->file.fileName() << ":"
+                         << state->file.errorString();
+    }
+
+    state->file.close();
+
+    return isWritten;
+}
+
+qint64 QOrmTracer::timestamp()
+{
+    return steadyClockNsecs() - tracerState()->epoch.load(std::memory_order_acquire);
+}
+
+void QOrmTracer::addEvent(quint64 session,
+                          const char* category,
+                          const char* name,
+                          qint64 startTimestamp,
+                          const QString& detail)
+{
+    TracerState* state = tracerState();
+    qint64 endTimestamp = timestamp();
+
+    QMutexLocker locker{&state->mutex};
+
+    // tracing was stopped, or stopped and started again, while the scope was active
+    if (!isEnabled() || session != s_session.load(std::memory_order_relaxed))
+        return;
+
+    Qt::HANDLE threadHandle = QThread::currentThreadId();
+    auto it = state->threadIds.find(threadHandle);
+
+    if (it == std::end(state->threadIds))
+        it = state->threadIds.insert(threadHandle, state->threadIds.size() + 1);
+
+    state->events.push_back(
+        {category, name, startTimestamp, endTimestamp - startTimestamp, it.value(), detail});
+}
+
+QT_END_NAMESPACE
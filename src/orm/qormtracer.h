@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMTRACER_H
+#define QORMTRACER_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qstring.h>
+
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+
+// Records the duration of ORM operations as complete events in the Chrome trace event format.
+// The resulting file can be loaded into chrome://tracing or the Perfetto UI. Events are kept in
+// memory while tracing and written out when the tracer is stopped.
+class Q_ORM_EXPORT QOrmTracer
+{
+public:
+    // Returns false if tracing is already active or the file cannot be opened for writing
+    static bool start(const QString& fileName);
+
+    // Writes the recorded events to the file passed to start(). Returns false if nothing was
+    // being traced or the file could not be written.
+    static bool stop();
+
+    Q_REQUIRED_RESULT
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Counts the calls to start(): events of scopes begun in an earlier tracing session are
+    // dropped, as their timestamps refer to another clock
+    Q_REQUIRED_RESULT
+    static quint64 session() { return s_session.load(std::memory_order_acquire); }
+
+    // Nanoseconds since start()
+    Q_REQUIRED_RESULT
+    static qint64 timestamp();
+
+    // Records an event from startTimestamp until now on the current thread, unless the tracing
+    // session is not the current one
+    static void addEvent(quint64 session,
+                         const char* category,
+                         const char* name,
+                         qint64 startTimestamp,
+                         const QString& detail);
+
+private:
+    static std::atomic<bool> s_enabled;
+    static std::atomic<quint64> s_session;
+};
+
+// Records the lifetime of the scope as a trace event. Does nothing but checking a flag when
+// tracing is disabled.
+class QOrmTraceScope
+{
+public:
+    QOrmTraceScope(const char* category, const char* name, QString detail = QString{})
+        : m_category{category}
+        , m_name{name}
+        , m_detail{std::move(detail)}
+    {
+        if (QOrmTracer::isEnabled())
+        {
+            m_session = QOrmTracer::session();
+            m_startTimestamp = QOrmTracer::timestamp();
+        }
+    }
+
+    ~QOrmTraceScope()
+    {
+        if (m_startTimestamp >= 0)
+            QOrmTracer::addEvent(m_session, m_category, m_name, m_startTimestamp, m_detail);
+    }
+
+    Q_DISABLE_COPY(QOrmTraceScope)
+
+    Q_REQUIRED_RESULT
+    bool isActive() const { return m_startTimestamp >= 0; }
+
+private:
+    const char* m_category;
+    const char* m_name;
+    quint64 m_session{0};
+    qint64 m_startTimestamp{-1};
+    QString m_detail;
+};
+
+#define Q_ORM_TRACE_SCOPE_CONCAT_(a, b) a##b
+#define Q_ORM_TRACE_SCOPE_CONCAT(a, b) Q_ORM_TRACE_SCOPE_CONCAT_(a, b)
+// One variable per line, so that several scopes can be traced in the same block
+#define Q_ORM_TRACE_SCOPE_VARIABLE Q_ORM_TRACE_SCOPE_CONCAT(qormTraceScope, __LINE__)
+
+#define Q_ORM_TRACE_SCOPE(category, name) QOrmTraceScope Q_ORM_TRACE_SCOPE_VARIABLE{category, name}
+
+// A single declaration; the detail expression is only evaluated when tracing is enabled
+#define Q_ORM_TRACE_SCOPE_DETAIL(category, name, detail)                                           \
+    QOrmTraceScope Q_ORM_TRACE_SCOPE_VARIABLE{category,                                            \
+                                              name,                                                \
+                                              QOrmTracer::isEnabled() ? QString{detail}            \
+                                                                      : QString{}}
+
+QT_END_NAMESPACE
+
+#endif // QORMTRACER_H
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMVALUERESULT_H
+#define QORMVALUERESULT_H
+
+#include <QtOrm/qormerror.h>
+#include <QtOrm/qormglobal.h>
+#include <QtOrm/qormrowset.h>
+
+#include <QtCore/qobject.h>
+#include <QtCore/qvector.h>
+
+#include <type_traits>
+
+QT_BEGIN_NAMESPACE
+
+// Values of a Q_GADGET entity read with QOrmQueryBuilder::selectValues(). The values are
+// stored contiguously and are neither cached nor tracked by the session.
+template<typename T>
+class QOrmValueResult
+{
+public:
+    using Projection = T;
+    static_assert(!std::is_convertible_v<Projection*, QObject*>,
+                  "Projection entity must be a Q_GADGET, use select() for QObject entities");
+
+    explicit QOrmValueResult(const QOrmRowSet& rowSet)
+        : m_error{rowSet.error()}
+    {
+        if (m_error.type() == QOrm::ErrorType::None)
+            m_result = rowSet.toValues<Projection>();
+    }
+
+    Q_REQUIRED_RESULT
+    const QOrmError& error() const { return m_error; }
+
+    Q_REQUIRED_RESULT
+    const QVector<Projection>& toVector() const
+    {
+        if (m_error.type() != QOrm::ErrorType::None)
+        {
+            qFatal("qtorm: QOrmValueResult::toVector() has been called but the result contains an "
+                   "error: %s",
+                   qPrintable(m_error.text()));
+        }
+
+        return m_result;
+    }
+
+private:
+    QOrmError m_error;
+    QVector<Projection> m_result;
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMVALUERESULT_H
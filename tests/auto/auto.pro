@@ -3,6 +3,7 @@ TEMPLATE = subdirs
 SUBDIRS += \
     domainclasses \
     qormentityinstancecache \
+    qormentitylistmodel \
     qormmetadatacache \
     qormsession \
     qormfilterexpression \
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include <QOrmEntityListModel>
+#include <QOrmError>
+#include <QOrmSession>
+#include <QOrmSessionStatistics>
+
+#include "domain/province.h"
+#include "domain/town.h"
+
+class EntityListModelTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testCreateInsertsRowInOrder();
+    void testRemoveRemovesRow();
+    void testUpdateMovesRow();
+    void testOrderChangeResetsModel();
+    void testFetchMoreAppendsPages();
+    void testFetchMoreWithDescendingNullableOrder();
+    void testCollectionValueFollowsNotify();
+    void testRemoveAfterReadingCollectionValue();
+};
+
+void EntityListModelTest::init()
+{
+    QFile db{"testdb.db"};
+
+    if (db.exists())
+        QVERIFY(db.remove());
+
+    qRegisterOrmEntity<Town, Province>();
+}
+
+void EntityListModelTest::testCreateInsertsRowInOrder()
+{
+    QOrmSession session;
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Kärnten")),
+                          new Province(QString::fromUtf8("Tirol"))));
+
+    QOrmEntityListModel<Province> model{session};
+    model.setOrder({QString::fromUtf8("name")});
+    QCOMPARE(model.rowCount(), 2);
+
+    QSignalSpy resetSpy{&model, &QAbstractItemModel::modelReset};
+    QSignalSpy insertSpy{&model, &QAbstractItemModel::rowsInserted};
+
+    QObject* salzburg = model.create({{QString::fromUtf8("name"), QString::fromUtf8("Salzburg")}});
+    QVERIFY(salzburg != nullptr);
+
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(insertSpy.first().at(1).toInt(), 1);
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.at(1), salzburg);
+}
+
+void EntityListModelTest::testRemoveRemovesRow()
+{
+    QOrmSession session;
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Kärnten")),
+                          new Province(QString::fromUtf8("Salzburg")),
+                          new Province(QString::fromUtf8("Tirol"))));
+
+    QOrmEntityListModel<Province> model{session};
+    QCOMPARE(model.rowCount(), 3);
+
+    QSignalSpy resetSpy{&model, &QAbstractItemModel::modelReset};
+    QSignalSpy removeSpy{&model, &QAbstractItemModel::rowsRemoved};
+
+    QVERIFY(model.removeAt(1));
+
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(removeSpy.count(), 1);
+    QCOMPARE(removeSpy.first().at(1).toInt(), 1);
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.at(1)->property("name").toString(), QString::fromUtf8("Tirol"));
+
+    QVERIFY(!model.removeAt(2));
+}
+
+void EntityListModelTest::testUpdateMovesRow()
+{
+    QOrmSession session;
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Kärnten")),
+                          new Province(QString::fromUtf8("Salzburg")),
+                          new Province(QString::fromUtf8("Tirol"))));
+
+    QOrmEntityListModel<Province> model{session};
+    model.setOrder({QString::fromUtf8("name")});
+
+    QSignalSpy moveSpy{&model, &QAbstractItemModel::rowsMoved};
+    QSignalSpy dataChangedSpy{&model, &QAbstractItemModel::dataChanged};
+
+    auto* carinthia = qobject_cast<Province*>(model.at(0));
+    carinthia->setName(QString::fromUtf8("Wien"));
+    QVERIFY(model.update(carinthia));
+
+    QCOMPARE(moveSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.count(), 1);
+    QCOMPARE(model.indexOf(carinthia), 2);
+    QCOMPARE(model.at(0)->property("name").toString(), QString::fromUtf8("Salzburg"));
+}
+
+void EntityListModelTest::testOrderChangeResetsModel()
+{
+    QOrmSession session;
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Tirol")),
+                          new Province(QString::fromUtf8("Kärnten"))));
+
+    QOrmEntityListModel<Province> model{session};
+
+    QSignalSpy resetSpy{&model, &QAbstractItemModel::modelReset};
+    model.setOrder({QString::fromUtf8("name")});
+
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(model.at(0)->property("name").toString(), QString::fromUtf8("Kärnten"));
+}
+
+void EntityListModelTest::testFetchMoreAppendsPages()
+{
+    QOrmSession session;
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Tirol")),
+                          new Province(QString::fromUtf8("Kärnten")),
+                          new Province(QString::fromUtf8("Salzburg")),
+                          new Province(QString::fromUtf8("Tirol")),
+                          new Province(QString::fromUtf8("Wien"))));
+
+    auto readStatementCount = [&session]() {
+        return session.statistics().statementStatistics(QOrm::Operation::Read).statementCount();
+    };
+    quint64 statementCount = readStatementCount();
+
+    // the rows are read on first access, with the page size set after the construction
+    QOrmEntityListModel<Province> model{session};
+    model.setOrder({QString::fromUtf8("name")});
+    model.setPageSize(3);
+    QCOMPARE(readStatementCount(), statementCount);
+
+    QCOMPARE(model.rowCount(), 3);
+    QVERIFY(readStatementCount() > statementCount);
+    QVERIFY(model.canFetchMore(QModelIndex{}));
+
+    QSignalSpy insertSpy{&model, &QAbstractItemModel::rowsInserted};
+    model.fetchMore(QModelIndex{});
+
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(insertSpy.first().at(1).toInt(), 3);
+    QCOMPARE(insertSpy.first().at(2).toInt(), 4);
+    QCOMPARE(model.rowCount(), 5);
+    QVERIFY(!model.canFetchMore(QModelIndex{}));
+
+    // equal names are ordered by ID, so the page boundary neither skips nor repeats a row
+    QCOMPARE(model.at(2)->property("name").toString(), QString::fromUtf8("Tirol"));
+    QCOMPARE(model.at(3)->property("name").toString(), QString::fromUtf8("Tirol"));
+    QVERIFY(model.at(2) != model.at(3));
+    QCOMPARE(model.at(4)->property("name").toString(), QString::fromUtf8("Wien"));
+}
+
+void EntityListModelTest::testFetchMoreWithDescendingNullableOrder()
+{
+    QOrmSession session;
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Tirol")),
+                          new Province(QString{}),
+                          new Province(QString::fromUtf8("Kärnten")),
+                          new Province(QString::fromUtf8("Wien"))));
+
+    QOrmEntityListModel<Province> model{session};
+    model.setOrder({QVariantMap{{"name", QVariant::fromValue(Qt::DescendingOrder)}}});
+    model.setPageSize(2);
+
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.at(1)->property("name").toString(), QString::fromUtf8("Tirol"));
+
+    model.fetchMore(QModelIndex{});
+    QCOMPARE(model.rowCount(), 4);
+
+    // SQLite sorts NULL first, so the row without a name comes last in descending order
+    QCOMPARE(model.at(2)->property("name").toString(), QString::fromUtf8("Kärnten"));
+    QVERIFY(model.at(3)->property("name").toString().isNull());
+}
+
+void EntityListModelTest::testCollectionValueFollowsNotify()
+{
+    QOrmSession session;
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Kärnten"))));
+
+    QOrmEntityListModel<Province> model{session};
+    auto* carinthia = qobject_cast<Province*>(model.at(0));
+    QCOMPARE(model.indexOf(carinthia), 0);
+
+    int townsRole = model.roleNames().key("towns");
+    QModelIndex index = model.index(0);
+    QVERIFY(model.data(index, townsRole).toList().isEmpty());
+
+    QSignalSpy dataChangedSpy{&model, &QAbstractItemModel::dataChanged};
+
+    Town villach{QString::fromUtf8("Villach"), carinthia};
+    carinthia->setTowns({&villach});
+
+    QCOMPARE(dataChangedSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.first().at(2).value<QVector<int>>(), QVector<int>{townsRole});
+
+    QVariantList towns = model.data(index, townsRole).toList();
+    QCOMPARE(towns.size(), 1);
+    QCOMPARE(towns.first().value<QObject*>(), &villach);
+
+    carinthia->setTowns({});
+}
+
+void EntityListModelTest::testRemoveAfterReadingCollectionValue()
+{
+    QOrmSession session;
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Kärnten")),
+                          new Province(QString::fromUtf8("Tirol"))));
+
+    QOrmEntityListModel<Province> model{session};
+    model.setOrder({QString::fromUtf8("name")});
+
+    // the cached value of the towns role connects the model to the instance
+    int townsRole = model.roleNames().key("towns");
+    QVERIFY(model.data(model.index(0), townsRole).toList().isEmpty());
+
+    QSignalSpy removeSpy{&model, &QAbstractItemModel::rowsRemoved};
+
+    // outside of a transaction the session deletes the removed instance
+    QVERIFY(model.removeAt(0));
+
+    QCOMPARE(removeSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.at(0)->property("name").toString(), QString::fromUtf8("Tirol"));
+    QVERIFY(model.data(model.index(0), townsRole).toList().isEmpty());
+
+    // forgets the cached values of the remaining instances only
+    model.read();
+    QCOMPARE(model.rowCount(), 1);
+}
+
+QTEST_GUILESS_MAIN(EntityListModelTest)
+
+#include "tst_ormentitylistmodel.moc"
@@ -40,6 +40,8 @@ private slots:
     void testDefaultMetadata();
     void testOneToOneReference();
     void testManyToOneReference();
+    void testMetadataSharedBetweenCaches();
+    void testConcurrentLookup();
 };
 
 MetadataCacheTest::MetadataCacheTest()
@@ -150,6 +152,8 @@ void MetadataCacheTest::testOneToOneReference()
     QVERIFY(provincePropertyMapping->isReference());
     QVERIFY(provincePropertyMapping->referencedEntity() != nullptr);
     QCOMPARE(provincePropertyMapping->referencedEntity()->className(), "Town");
+    QCOMPARE(provincePropertyMapping->backReference(),
+             cache.get<Town>().classPropertyMapping("population"));
 }
 
 void MetadataCacheTest::testManyToOneReference()
@@ -169,6 +173,43 @@ void MetadataCacheTest::testManyToOneReference()
     QVERIFY(populationPropertyMapping->isTransient());
     QVERIFY(populationPropertyMapping->referencedEntity() != nullptr);
     QCOMPARE(populationPropertyMapping->referencedEntity()->className(), "Person");
+    QCOMPARE(populationPropertyMapping->backReference(),
+             cache.get<Person>().classPropertyMapping("town"));
+}
+
+void MetadataCacheTest::testMetadataSharedBetweenCaches()
+{
+    QOrmMetadataCache cache;
+    QOrmMetadataCache otherCache;
+
+    QCOMPARE(&cache.get<Town>(), &otherCache.get<Town>());
+    QCOMPARE(&cache.get<Person>(), &otherCache.get<Person>());
+    QCOMPARE(cache.get<Town>().classPropertyMapping("population")->referencedEntity(),
+             &otherCache.get<Person>());
+}
+
+void MetadataCacheTest::testConcurrentLookup()
+{
+    QOrmMetadataCache cache;
+    const QOrmMetadata* expected = &cache.get<Province>();
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    std::vector<const QOrmMetadata*> results(8, nullptr);
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        threads.emplace_back(QThread::create([&results, i]() {
+            QOrmMetadataCache threadCache;
+            results[i] = &threadCache.get<Province>();
+        }));
+        threads.back()->start();
+    }
+
+    for (const std::unique_ptr<QThread>& thread : threads)
+        QVERIFY(thread->wait());
+
+    for (const QOrmMetadata* result : results)
+        QCOMPARE(result, expected);
 }
 
 QTEST_APPLESS_MAIN(MetadataCacheTest)
@@ -10,6 +10,7 @@ SOURCES +=  tst_ormsession.cpp \
     domain/person.cpp \
 
 HEADERS += \
+    domain/measurement.h \
     domain/province.h \
     domain/town.h \
     domain/person.h \
@@ -21,20 +21,31 @@
 
 #include <QtTest>
 
+#include <QOrmEntityInstanceCache>
 #include <QOrmError>
+#include <QOrmFilter>
 #include <QOrmMetadataCache>
+#include <QOrmPreparedQuery>
+#include <QOrmQuery>
+#include <QOrmQueryCache>
+#include <QOrmRelation>
+#include <QOrmRowSet>
 #include <QOrmSession>
+#include <QOrmSessionStatistics>
 #include <QOrmSqliteConfiguration>
 #include <QOrmSqliteProvider>
+#include <QOrmTracer>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QSqlRecord>
 
+#include "domain/measurement.h"
 #include "domain/person.h"
 #include "domain/province.h"
 #include "domain/town.h"
 
+#include "private/qormcrossreferencevalidator_p.h"
 #include "private/qormglobal_p.h"
 
 class SqliteSessionTest : public QObject
@@ -50,6 +61,8 @@ private slots:
     void cleanup();
 
     void testCascadedCreate();
+    void testMergeGraph();
+    void testMergeGraphWithSelfReference();
 
     void testSelectWithOneToMany();
     void testSelectWithManyToOne();
@@ -57,16 +70,36 @@ private slots:
     void testSelectWithSingleStringFilter();
     void testSelectWithOrder();
     void testSelectFromNestedSelect();
+    void testSelectFromQueryCache();
+    void testQueryCacheWithOuterTransaction();
+    void testDeleteQueryInvalidatesCaches();
+    void testSelectWithIn();
+    void testSelectWithPreparedQuery();
+    void testSelectInMemory();
+    void testSelectWithInvokableFilter();
+    void testSelectWithPropertyPath();
+    void testSelectWithoutTracking();
+    void testSelectColumns();
+    void testGadgetEntities();
 
     void testMergeFailsWithInconsistentReferences();
     void testMergeOfExistingEntitiesWithExplicitIdsUpdates();
+    void testMergeOfExistingEntitiesWithUpsert();
+    void testMergeWithoutCrossReferenceValidation();
+    void testMergeAssignsConsecutiveRowIds();
 
     void testRemoveInstance();
 
     void testTransactionRollback();
+    void testTransactionRollbackOfCreatedInstance();
+    void testTransactionRollbackOfRemovedInstance();
 
     void testSchemaCreatedForReferencedEntities();
     void testSchemaUpdated();
+
+    void testStatistics();
+    void testSlowQueryLog();
+    void testTracing();
 };
 
 SqliteSessionTest::SqliteSessionTest()
@@ -133,6 +166,84 @@ void SqliteSessionTest::testCascadedCreate()
     QCOMPARE(query.numRowsAffected(), 1);
 }
 
+void SqliteSessionTest::testMergeGraph()
+{
+    QOrmSession session;
+    const QOrmSessionStatistics& statistics = session.statistics();
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+    Town* pregarten = new Town(QString::fromUtf8("Pregarten"), upperAustria);
+    Town* linz = new Town(QString::fromUtf8("Linz"), upperAustria);
+    upperAustria->setTowns({hagenberg, pregarten, linz});
+
+    // the towns are reached through the list of the province
+    QVERIFY(session.mergeGraph(upperAustria));
+
+    QCOMPARE(upperAustria->id(), 1);
+    QCOMPARE(hagenberg->id(), 1);
+    QCOMPARE(pregarten->id(), 2);
+    QCOMPARE(linz->id(), 3);
+    QVERIFY(session.entityInstanceCache()->contains(linz));
+    QCOMPARE(statistics.statementStatistics(QOrm::Operation::Create, "Town").statementCount(),
+             quint64{1});
+    QCOMPARE(statistics.statementStatistics(QOrm::Operation::Create).rowCount(), quint64{4});
+
+    session.resetStatistics();
+
+    // the province is modified with its list of towns, and the new town is reached through it
+    Town* engerwitzdorf = new Town(QString::fromUtf8("Engerwitzdorf"), upperAustria);
+    upperAustria->setTowns({hagenberg, pregarten, linz, engerwitzdorf});
+    pregarten->setName(QString::fromUtf8("Pregarten (Stadt)"));
+
+    QVERIFY(session.mergeGraph(hagenberg));
+
+    QCOMPARE(engerwitzdorf->id(), 4);
+    QCOMPARE(statistics.statementStatistics(QOrm::Operation::Update).rowCount(), quint64{2});
+    QCOMPARE(statistics.statementStatistics(QOrm::Operation::Create).rowCount(), quint64{1});
+    QVERIFY(!session.entityInstanceCache()->isModified(pregarten));
+
+    QOrmSqliteProvider* provider =
+        static_cast<QOrmSqliteProvider*>(session.configuration().provider());
+    QSqlQuery query{provider->database()};
+
+    QVERIFY(query.exec(
+        QString::fromUtf8("SELECT name FROM Town WHERE province_id = 1 ORDER BY id")));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QString::fromUtf8("Hagenberg"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QString::fromUtf8("Pregarten (Stadt)"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QString::fromUtf8("Linz"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QString::fromUtf8("Engerwitzdorf"));
+    QVERIFY(!query.next());
+}
+
+void SqliteSessionTest::testMergeGraphWithSelfReference()
+{
+    QOrmSession session;
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+    upperAustria->setTowns({hagenberg});
+
+    Person* parent = new Person(QString::fromUtf8("Franz"), QString::fromUtf8("Huber"), hagenberg);
+    Person* child = new Person(QString::fromUtf8("Anna"), QString::fromUtf8("Huber"), hagenberg);
+    child->setPersonParent(parent);
+    parent->setPersonChildren({child});
+
+    // Person references itself: the persons are merged one by one
+    QVERIFY(session.mergeGraph(child));
+
+    QVERIFY(upperAustria->id() != 0);
+    QVERIFY(hagenberg->id() != 0);
+    QVERIFY(parent->id() != 0);
+    QVERIFY(child->id() != 0);
+    QVERIFY(session.entityInstanceCache()->contains(parent));
+    QVERIFY(session.entityInstanceCache()->contains(child));
+}
+
 void SqliteSessionTest::testSelectWithOneToMany()
 {
     // prepare database
@@ -329,6 +440,489 @@ void SqliteSessionTest::testSelectFromNestedSelect()
     QCOMPARE(result.toVector().size(), 2);
 }
 
+void SqliteSessionTest::testSelectFromQueryCache()
+{
+    QOrmQueryCache queryCache;
+
+    {
+        QOrmSession session;
+        session.setQueryCache(&queryCache);
+
+        QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich")),
+                              new Province(QString::fromUtf8("Niederösterreich"))));
+
+        auto result = session.from<Province>()
+                          .filter(Q_ORM_CLASS_PROPERTY(name) == QString::fromUtf8("Oberösterreich"))
+                          .select();
+        QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+        QCOMPARE(queryCache.missCount(), quint64{1});
+        QCOMPARE(queryCache.count(), 1);
+        QVERIFY(queryCache.memoryUsage() > 0);
+
+        auto cachedResult =
+            session.from<Province>()
+                .filter(Q_ORM_CLASS_PROPERTY(name) == QString::fromUtf8("Oberösterreich"))
+                .select();
+        QCOMPARE(cachedResult.error().type(), QOrm::ErrorType::None);
+        QCOMPARE(queryCache.hitCount(), quint64{1});
+        QCOMPARE(cachedResult.toVector(), result.toVector());
+
+        // any merge to the table invalidates the cached results
+        QVERIFY(session.merge(new Province(QString::fromUtf8("Salzburg"))));
+        QCOMPARE(queryCache.count(), 0);
+    }
+
+    // the cached object IDs are resolved in another session
+    {
+        QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_bypass_schema.json")};
+        session.setQueryCache(&queryCache);
+
+        auto result = session.from<Province>().select();
+        QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+        QCOMPARE(result.toVector().size(), 3);
+    }
+
+    {
+        QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_bypass_schema.json")};
+        session.setQueryCache(&queryCache);
+
+        auto result = session.from<Province>().select();
+        QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+        QCOMPARE(result.toVector().size(), 3);
+        QCOMPARE(queryCache.hitCount(), quint64{2});
+        QCOMPARE(queryCache.hitRatio(), 0.5);
+    }
+}
+
+void SqliteSessionTest::testQueryCacheWithOuterTransaction()
+{
+    QOrmQueryCache queryCache;
+
+    QOrmSession writer;
+    writer.setQueryCache(&queryCache);
+    QVERIFY(writer.merge(new Province(QString::fromUtf8("Oberösterreich"))));
+
+    QOrmSession reader{QOrmSessionConfiguration::fromFile(":/qtorm_bypass_schema.json")};
+    reader.setQueryCache(&queryCache);
+
+    // filtered reads do not leave the entity fully loaded in the entity instance cache
+    auto readProvinceCount = [](QOrmSession& session) {
+        return session.from<Province>()
+            .filter(Q_ORM_CLASS_PROPERTY(id) > 0)
+            .select()
+            .toVector()
+            .size();
+    };
+
+    QVERIFY(writer.beginTransaction());
+    QVERIFY(writer.merge(new Province(QString::fromUtf8("Niederösterreich"))));
+
+    // the uncommitted result of the writer is not shared
+    QCOMPARE(readProvinceCount(writer), 2);
+    QCOMPARE(queryCache.count(), 0);
+
+    // the reader still sees and caches the committed rows
+    QCOMPARE(readProvinceCount(reader), 1);
+    QCOMPARE(queryCache.count(), 1);
+
+    QVERIFY(writer.commitTransaction());
+
+    // the commit drops the result cached while the transaction was open
+    QCOMPARE(queryCache.count(), 0);
+    QCOMPARE(readProvinceCount(reader), 2);
+}
+
+void SqliteSessionTest::testDeleteQueryInvalidatesCaches()
+{
+    QOrmQueryCache queryCache;
+    QOrmSession session;
+    session.setQueryCache(&queryCache);
+
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich")),
+                          new Province(QString::fromUtf8("Salzburg"))));
+
+    // marks the entity as fully loaded, and caches the filtered result
+    QCOMPARE(session.from<Province>().select().toVector().size(), 2);
+    QCOMPARE(session.from<Province>()
+                 .filter(Q_ORM_CLASS_PROPERTY(id) > 0)
+                 .select()
+                 .toVector()
+                 .size(),
+             2);
+    QCOMPARE(queryCache.count(), 1);
+
+    const QOrmMetadata& province = session.metadataCache()->get<Province>();
+    QOrmRelation relation{province};
+    QOrmQuery deleteQuery{QOrm::Operation::Delete,
+                          relation,
+                          province,
+                          QOrmFilter{QOrmPrivate::resolvedFilterExpression(
+                              relation,
+                              Q_ORM_CLASS_PROPERTY(name) == QString::fromUtf8("Salzburg"))},
+                          {},
+                          QOrm::QueryFlags::None};
+    QCOMPARE(session.execute(deleteQuery).error().type(), QOrm::ErrorType::None);
+
+    QCOMPARE(queryCache.count(), 0);
+    QCOMPARE(session.from<Province>()
+                 .filter(Q_ORM_CLASS_PROPERTY(id) > 0)
+                 .select()
+                 .toVector()
+                 .size(),
+             1);
+
+    // the deleted instance is still in the entity instance cache, which is no longer complete
+    QCOMPARE(session.from<Province>().select(QOrm::QueryFlags::PreferCache).toVector().size(), 1);
+}
+
+void SqliteSessionTest::testSelectWithIn()
+{
+    QOrmSession session;
+
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich")),
+                          new Province(QString::fromUtf8("Niederösterreich")),
+                          new Province(QString::fromUtf8("Salzburg"))));
+
+    auto result =
+        session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id).in(QVector<int>{1, 3})).select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector().size(), 2);
+
+    result =
+        session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id).notIn(QVector<int>{1, 3})).select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector().size(), 1);
+    QCOMPARE(result.toVector().first()->name(), QString::fromUtf8("Niederösterreich"));
+
+    result = session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id).in(QVector<int>{})).select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QVERIFY(result.toVector().isEmpty());
+
+    // bound as an array parameter
+    QVector<int> ids;
+
+    for (int id = 2; id < 500; ++id)
+        ids.push_back(id);
+
+    result = session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id).in(ids)).select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector().size(), 2);
+
+    // the table of the array parameter does not outlive the statement
+    QOrmSqliteProvider* provider =
+        static_cast<QOrmSqliteProvider*>(session.configuration().provider());
+    QSqlQuery query{provider->database()};
+    QVERIFY(query.exec("SELECT COUNT(*) FROM temp.sqlite_master WHERE name LIKE 'qtorm_array_%'"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 0);
+}
+
+void SqliteSessionTest::testSelectInMemory()
+{
+    QOrmSession session;
+
+    auto* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    auto* lowerAustria = new Province(QString::fromUtf8("Niederösterreich"));
+    auto* salzburg = new Province(QString::fromUtf8("Salzburg"));
+    QVERIFY(session.merge(upperAustria, lowerAustria, salzburg));
+
+    // the cache may miss rows until the entity has been read without restrictions
+    auto result = session.from<Province>().select(QOrm::QueryFlags::PreferCache);
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector().size(), 3);
+
+    // unsaved changes are visible to in-memory queries
+    salzburg->setName(QStringLiteral("Wien"));
+
+    result = session.from<Province>()
+                 .filter(Q_ORM_CLASS_PROPERTY(name) == QStringLiteral("Wien"))
+                 .select(QOrm::QueryFlags::InMemory);
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), (QVector<Province*>{salzburg}));
+
+    result = session.from<Province>()
+                 .filter(Q_ORM_CLASS_PROPERTY(id) > 1)
+                 .order(Q_ORM_CLASS_PROPERTY(name), Qt::DescendingOrder)
+                 .select(QOrm::QueryFlags::PreferCache);
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), (QVector<Province*>{salzburg, lowerAustria}));
+
+    result = session.from<Province>()
+                 .filter(Q_ORM_CLASS_PROPERTY(id).in(QVector<int>{1, 3}) ||
+                         Q_ORM_CLASS_PROPERTY(name) == QStringLiteral("Tirol"))
+                 .order(Q_ORM_CLASS_PROPERTY(name))
+                 .offset(1)
+                 .limit(5)
+                 .select(QOrm::QueryFlags::InMemory);
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), (QVector<Province*>{salzburg}));
+
+    // the backend still has the persisted name
+    result = session.from<Province>()
+                 .filter(Q_ORM_CLASS_PROPERTY(name) == QStringLiteral("Wien"))
+                 .select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QVERIFY(result.toVector().isEmpty());
+}
+
+void SqliteSessionTest::testSelectWithInvokableFilter()
+{
+    QOrmSession session;
+
+    auto* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    auto* lowerAustria = new Province(QString::fromUtf8("Niederösterreich"));
+    auto* salzburg = new Province(QString::fromUtf8("Salzburg"));
+    auto* tyrol = new Province(QString::fromUtf8("Tirol"));
+    QVERIFY(session.merge(upperAustria, lowerAustria, salzburg, tyrol));
+
+    int invocationCount = 0;
+    auto isAustria = [&invocationCount](const Province* province) {
+        ++invocationCount;
+        return province->name().endsWith(QString::fromUtf8("österreich"));
+    };
+
+    // only the rows passing the expression filter reach the invokable filter
+    auto result = session.from<Province>()
+                      .filter(isAustria)
+                      .filter(Q_ORM_CLASS_PROPERTY(name) != QStringLiteral("Tirol"))
+                      .order(Q_ORM_CLASS_PROPERTY(name))
+                      .select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), (QVector<Province*>{lowerAustria, upperAustria}));
+    QCOMPARE(invocationCount, 3);
+
+    // limit and offset apply to the rows passing the invokable filter
+    result = session.from<Province>()
+                 .filter(isAustria)
+                 .order(Q_ORM_CLASS_PROPERTY(name))
+                 .offset(1)
+                 .limit(1)
+                 .select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), (QVector<Province*>{upperAustria}));
+}
+
+void SqliteSessionTest::testSelectWithPropertyPath()
+{
+    QOrmSession session;
+
+    auto* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    auto* salzburg = new Province(QString::fromUtf8("Salzburg"));
+    auto* linz = new Town(QString::fromUtf8("Linz"), upperAustria);
+    auto* hallein = new Town(QString::fromUtf8("Hallein"), salzburg);
+    auto* salzburgCity = new Town(QString::fromUtf8("Salzburg"), salzburg);
+    auto* nowhere = new Town(QString::fromUtf8("Nirgendwo"), nullptr);
+    upperAustria->setTowns({linz});
+    salzburg->setTowns({hallein, salzburgCity});
+    QVERIFY(session.merge(linz, hallein, salzburgCity, nowhere, upperAustria, salzburg));
+
+    auto result = session.from<Town>()
+                      .filter(Q_ORM_CLASS_PROPERTY(province.name) == QString::fromUtf8("Salzburg"))
+                      .order(Q_ORM_CLASS_PROPERTY(name))
+                      .select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), (QVector<Town*>{hallein, salzburgCity}));
+
+    // towns without a province are kept by disjunctions and excluded by negations
+    result = session.from<Town>()
+                 .filter(Q_ORM_CLASS_PROPERTY(province.name) == QString::fromUtf8("Tirol") ||
+                         Q_ORM_CLASS_PROPERTY(name) == QString::fromUtf8("Nirgendwo"))
+                 .select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), (QVector<Town*>{nowhere}));
+
+    result = session.from<Town>()
+                 .filter(!(Q_ORM_CLASS_PROPERTY(province.name) == QString::fromUtf8("Salzburg")))
+                 .select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), (QVector<Town*>{linz}));
+
+    // in-memory evaluation follows the references
+    result = session.from<Town>()
+                 .filter(Q_ORM_CLASS_PROPERTY(province.name) == QString::fromUtf8("Salzburg"))
+                 .order(Q_ORM_CLASS_PROPERTY(name), Qt::DescendingOrder)
+                 .select(QOrm::QueryFlags::InMemory);
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), (QVector<Town*>{salzburgCity, hallein}));
+
+    // and the same three-valued logic
+    result = session.from<Town>()
+                 .filter(!(Q_ORM_CLASS_PROPERTY(province.name) == QString::fromUtf8("Salzburg")))
+                 .select(QOrm::QueryFlags::InMemory);
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), (QVector<Town*>{linz}));
+
+    result = session.from<Town>()
+                 .filter(Q_ORM_CLASS_PROPERTY(province.name) == QString::fromUtf8("Tirol") ||
+                         Q_ORM_CLASS_PROPERTY(name) == QString::fromUtf8("Nirgendwo"))
+                 .select(QOrm::QueryFlags::InMemory);
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), (QVector<Town*>{nowhere}));
+}
+
+void SqliteSessionTest::testSelectWithPreparedQuery()
+{
+    QOrmSession session;
+
+    auto* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    auto* salzburg = new Province(QString::fromUtf8("Salzburg"));
+    auto* linz = new Town(QString::fromUtf8("Linz"), upperAustria);
+    auto* hallein = new Town(QString::fromUtf8("Hallein"), salzburg);
+    upperAustria->setTowns({linz});
+    salzburg->setTowns({hallein});
+    QVERIFY(session.merge(linz, hallein, upperAustria, salzburg));
+
+    auto provinceQuery =
+        session.from<Province>()
+            .filter(Q_ORM_CLASS_PROPERTY(name) == QOrmQueryParameter{QStringLiteral("name")})
+            .prepare();
+
+    // unbound parameter
+    auto result = provinceQuery.select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::Other);
+
+    result = provinceQuery.bind(QStringLiteral("name"), QString::fromUtf8("Salzburg")).select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), QVector<Province*>{salzburg});
+
+    result = provinceQuery.bind(QStringLiteral("name"), QString::fromUtf8("Oberösterreich")).select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector(), QVector<Province*>{upperAustria});
+
+    // entity instances are bound by their object IDs
+    auto townQuery =
+        session.from<Town>()
+            .filter(Q_ORM_CLASS_PROPERTY(province) == QOrmQueryParameter{QStringLiteral("province")})
+            .prepare();
+
+    auto towns = townQuery.bind(QStringLiteral("province"), salzburg).select();
+    QCOMPARE(towns.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(towns.toVector(), QVector<Town*>{hallein});
+
+    towns = townQuery.bind(QStringLiteral("province"), upperAustria).select();
+    QCOMPARE(towns.toVector(), QVector<Town*>{linz});
+}
+
+void SqliteSessionTest::testSelectWithoutTracking()
+{
+    QOrmSession session;
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+    Town* pregarten = new Town(QString::fromUtf8("Pregarten"), upperAustria);
+    upperAustria->setTowns({hagenberg, pregarten});
+    QVERIFY(session.merge(hagenberg, pregarten, upperAustria));
+
+    QPointer<Town> detachedTown;
+
+    {
+        QOrmQueryResult<Town> result =
+            session.from<Town>()
+                .filter(Q_ORM_CLASS_PROPERTY(name) == QString::fromUtf8("Hagenberg"))
+                .select(QOrm::QueryFlags::NoTracking);
+
+        QCOMPARE(result.toVector().size(), 1);
+        QVERIFY(result.owner() != nullptr);
+
+        Town* town = result.toVector().front();
+        QVERIFY(town != hagenberg);
+        QCOMPARE(town->name(), hagenberg->name());
+        QVERIFY(!session.entityInstanceCache()->contains(town));
+
+        // references are resolved within the result
+        QVERIFY(town->province() != nullptr);
+        QVERIFY(town->province() != upperAustria);
+        QVERIFY(!session.entityInstanceCache()->contains(town->province()));
+        QCOMPARE(town->province()->towns().size(), 2);
+        QVERIFY(town->province()->towns().contains(town));
+
+        town->setName(QString::fromUtf8("Linz"));
+        detachedTown = town;
+    }
+
+    // the detached instances are deleted with the result and their changes were not tracked
+    QVERIFY(detachedTown.isNull());
+    QCOMPARE(session.from<Town>()
+                 .filter(Q_ORM_CLASS_PROPERTY(name) == QString::fromUtf8("Linz"))
+                 .select()
+                 .toVector()
+                 .size(),
+             0);
+}
+
+void SqliteSessionTest::testSelectColumns()
+{
+    QOrmSession session;
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+    Town* pregarten = new Town(QString::fromUtf8("Pregarten"), upperAustria);
+    upperAustria->setTowns({hagenberg, pregarten});
+    QVERIFY(session.merge(hagenberg, pregarten, upperAustria));
+
+    quint64 missCount = session.statistics().entityInstanceCacheMissCount();
+
+    QOrmRowSet rowSet = session.from<Town>()
+                            .order(Q_ORM_CLASS_PROPERTY(name), Qt::DescendingOrder)
+                            .selectColumns({Q_ORM_CLASS_PROPERTY(id),
+                                            Q_ORM_CLASS_PROPERTY(name),
+                                            Q_ORM_CLASS_PROPERTY(province)});
+
+    QCOMPARE(rowSet.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(rowSet.columnNames(),
+             (QStringList{QString::fromUtf8("id"),
+                          QString::fromUtf8("name"),
+                          QString::fromUtf8("province")}));
+    QCOMPARE(rowSet.rowCount(), 2);
+
+    // references are read as the object IDs of the referenced entity instances
+    QCOMPARE(rowSet.value(0, 1).toString(), pregarten->name());
+    QCOMPARE(rowSet.value(1, 1).toString(), hagenberg->name());
+    QCOMPARE(rowSet.value(0, 2).toInt(), upperAustria->id());
+    QCOMPARE(rowSet.columnValues<int>(rowSet.columnIndex(QString::fromUtf8("id"))),
+             (QVector<int>{pregarten->id(), hagenberg->id()}));
+
+    std::vector<std::tuple<int, QString, int>> tuples = rowSet.toTuples<int, QString, int>();
+    QCOMPARE(tuples.size(), size_t{2});
+    QVERIFY(tuples[1] == std::make_tuple(hagenberg->id(), hagenberg->name(), upperAustria->id()));
+
+    // no entity instances are created
+    QCOMPARE(session.statistics().entityInstanceCacheMissCount(), missCount);
+}
+
+void SqliteSessionTest::testGadgetEntities()
+{
+    QOrmSession session;
+
+    // more rows than fit into a single INSERT statement
+    QVector<Measurement> measurements(1500);
+
+    for (int i = 0; i < measurements.size(); ++i)
+    {
+        measurements[i].sensor = QString::fromUtf8("sensor%1").arg(i % 3);
+        measurements[i].value = i * 0.5;
+    }
+
+    QVERIFY(session.insertValues(measurements));
+    QCOMPARE(session.lastError().type(), QOrm::ErrorType::None);
+
+    QOrmValueResult<Measurement> result =
+        session.from<Measurement>()
+            .filter(Q_ORM_CLASS_PROPERTY(sensor) == QString::fromUtf8("sensor1"))
+            .order(Q_ORM_CLASS_PROPERTY(value))
+            .selectValues();
+
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+
+    const QVector<Measurement>& values = result.toVector();
+    QCOMPARE(values.size(), 500);
+    QCOMPARE(values.front().sensor, QString::fromUtf8("sensor1"));
+    QCOMPARE(values.front().value, 0.5);
+    QCOMPARE(values.back().value, 749.0);
+    QVERIFY(values.front().id > 0);
+    QVERIFY(values.front().id < values.back().id);
+}
+
 void SqliteSessionTest::testMergeFailsWithInconsistentReferences()
 {
     QOrmSession session;
@@ -343,17 +937,69 @@ void SqliteSessionTest::testMergeFailsWithInconsistentReferences()
 
     upperAustria->setTowns({pregarten});
 
-    QVERIFY(QOrmPrivate::crossReferenceError(metadataCache->get<Town>(), hagenberg).has_value());
-    QVERIFY(!QOrmPrivate::crossReferenceError(metadataCache->get<Town>(), pregarten).has_value());
-    QVERIFY(QOrmPrivate::crossReferenceError(metadataCache->get<Town>(), melk).has_value());
+    QOrmCrossReferenceValidator validator;
+
+    QVERIFY(validator.validate(metadataCache->get<Town>(), hagenberg).has_value());
+    QVERIFY(!validator.validate(metadataCache->get<Town>(), pregarten).has_value());
+    QVERIFY(validator.validate(metadataCache->get<Town>(), melk).has_value());
 
     // Province instances to have a cross-reference error but it cannot be detected because the
     // referencing issues are not in the list. The cross-reference is detected on the other side
     // of the relation.
-    QVERIFY(!QOrmPrivate::crossReferenceError(metadataCache->get<Province>(), upperAustria)
-                 .has_value());
-    QVERIFY(!QOrmPrivate::crossReferenceError(metadataCache->get<Province>(), lowerAustria)
-                 .has_value());
+    QVERIFY(!validator.validate(metadataCache->get<Province>(), upperAustria).has_value());
+    QVERIFY(!validator.validate(metadataCache->get<Province>(), lowerAustria).has_value());
+
+    // the memoized back-references follow the changes of the list
+    upperAustria->setTowns({pregarten, hagenberg});
+    QVERIFY(!validator.validate(metadataCache->get<Town>(), hagenberg).has_value());
+
+    upperAustria->setTowns({hagenberg});
+    QVERIFY(validator.validate(metadataCache->get<Town>(), pregarten).has_value());
+}
+
+void SqliteSessionTest::testMergeWithoutCrossReferenceValidation()
+{
+    QOrmSessionConfiguration configuration = QOrmSessionConfiguration::defaultConfiguration();
+    configuration.setCrossReferenceValidation(QOrm::CrossReferenceValidation::Off);
+    QOrmSession session{configuration};
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+
+    // the back-reference Province::towns does not list hagenberg
+    QVERIFY(session.merge(hagenberg));
+    QCOMPARE(session.from<Town>().select().toVector().size(), 1);
+}
+
+void SqliteSessionTest::testMergeAssignsConsecutiveRowIds()
+{
+    QOrmSession session;
+
+    auto* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    auto* lowerAustria = new Province(QString::fromUtf8("Niederösterreich"));
+    QVERIFY(session.merge(upperAustria, lowerAustria));
+    QVERIFY(session.remove(lowerAustria));
+
+    // AUTOINCREMENT does not reuse the rowid of the removed row
+    auto* salzburg = new Province(QString::fromUtf8("Salzburg"));
+    auto* tyrol = new Province(QString::fromUtf8("Tirol"));
+    QVERIFY(session.merge(salzburg, tyrol));
+    QCOMPARE(salzburg->id(), 3);
+    QCOMPARE(tyrol->id(), 4);
+
+    QOrmSqliteProvider* provider =
+        static_cast<QOrmSqliteProvider*>(session.configuration().provider());
+    QSqlQuery query{provider->database()};
+
+    // the rows inserted by the trigger take the rowids in between those of the merged rows
+    QVERIFY(query.exec("CREATE TRIGGER copyProvince AFTER INSERT ON Province "
+                       "WHEN NEW.name <> 'Copy' "
+                       "BEGIN INSERT INTO Province(name) VALUES('Copy'); END"));
+
+    auto* vienna = new Province(QString::fromUtf8("Wien"));
+    auto* styria = new Province(QString::fromUtf8("Steiermark"));
+    QVERIFY(!session.merge(vienna, styria));
+    QCOMPARE(session.lastError().type(), QOrm::ErrorType::UnsynchronizedEntity);
 }
 
 void SqliteSessionTest::testMergeOfExistingEntitiesWithExplicitIdsUpdates()
@@ -389,6 +1035,74 @@ void SqliteSessionTest::testMergeOfExistingEntitiesWithExplicitIdsUpdates()
     }
 }
 
+void SqliteSessionTest::testMergeOfExistingEntitiesWithUpsert()
+{
+    int idUpperAustria = -1;
+    int idLowerAustria = -1;
+
+    {
+        QOrmSession session;
+
+        Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+        Province* lowerAustria = new Province(QString::fromUtf8("Niederösterreich"));
+
+        QVERIFY(session.merge(upperAustria, lowerAustria));
+
+        idUpperAustria = upperAustria->id();
+        idLowerAustria = lowerAustria->id();
+    }
+
+    QOrmSessionConfiguration configuration =
+        QOrmSessionConfiguration::fromFile(":/qtorm_bypass_schema.json");
+    configuration.setMergeMode(QOrm::MergeMode::Upsert);
+
+    {
+        QOrmSession session{configuration};
+
+        Province* upperAustria = new Province(idUpperAustria, QString::fromUtf8("OÖ"));
+        Province* salzburg = new Province(idLowerAustria + 1, QString::fromUtf8("Salzburg"));
+
+        QVERIFY(session.merge(upperAustria, salzburg));
+
+        QCOMPARE(upperAustria->id(), idUpperAustria);
+        QCOMPARE(salzburg->id(), idLowerAustria + 1);
+        QVERIFY(session.entityInstanceCache()->contains(upperAustria));
+        QCOMPARE(session.statistics().statementStatistics(QOrm::Operation::Merge).statementCount(),
+                 quint64{2});
+
+        // a single statement per entity
+        Province* lowerAustria = new Province(idLowerAustria, QString::fromUtf8("NÖ"));
+        Town* melk = new Town(QString::fromUtf8("Melk"), lowerAustria);
+        melk->setId(1);
+        Town* gmuend = new Town(QString::fromUtf8("Gmünd"), lowerAustria);
+        gmuend->setId(2);
+        lowerAustria->setTowns({melk, gmuend});
+
+        session.resetStatistics();
+        QVERIFY(session.mergeGraph(lowerAustria));
+
+        QOrmStatementStatistics upserts =
+            session.statistics().statementStatistics(QOrm::Operation::Merge);
+        QCOMPARE(upserts.statementCount(), quint64{2});
+        QCOMPARE(upserts.rowCount(), quint64{3});
+    }
+
+    {
+        QOrmSession session{configuration};
+
+        QVector<Province*> provinces = session.from<Province>()
+                                           .order(Q_ORM_CLASS_PROPERTY(id))
+                                           .select()
+                                           .toVector();
+
+        QCOMPARE(provinces.size(), 3);
+        QCOMPARE(provinces[0]->name(), QString::fromUtf8("OÖ"));
+        QCOMPARE(provinces[1]->name(), QString::fromUtf8("NÖ"));
+        QCOMPARE(provinces[2]->name(), QString::fromUtf8("Salzburg"));
+        QCOMPARE(provinces[1]->towns().size(), 2);
+    }
+}
+
 void SqliteSessionTest::testTransactionRollback()
 {
     QOrmSession session;
@@ -409,6 +1123,55 @@ void SqliteSessionTest::testTransactionRollback()
     QCOMPARE(upperAustria->name(), QString::fromUtf8("Oberösterreich"));
 }
 
+void SqliteSessionTest::testTransactionRollbackOfCreatedInstance()
+{
+    QOrmSession session;
+
+    Province* upperAustria = new Province(0, QString::fromUtf8("Oberösterreich"));
+
+    {
+        auto transactionToken = session.declareTransaction(QOrm::TransactionPropagation::Require,
+                                                           QOrm::TransactionAction::Rollback);
+
+        QVERIFY(session.merge(upperAustria));
+        QCOMPARE(upperAustria->id(), 1);
+        QVERIFY(session.entityInstanceCache()->contains(upperAustria));
+    }
+
+    QCOMPARE(upperAustria->id(), 0);
+    QCOMPARE(upperAustria->name(), QString::fromUtf8("Oberösterreich"));
+    QVERIFY(!session.entityInstanceCache()->contains(upperAustria));
+    QVERIFY(session.from<Province>().select().toVector().empty());
+
+    delete upperAustria;
+}
+
+void SqliteSessionTest::testTransactionRollbackOfRemovedInstance()
+{
+    QOrmSession session;
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    QVERIFY(session.merge(upperAustria));
+
+    {
+        auto transactionToken = session.declareTransaction(QOrm::TransactionPropagation::Require,
+                                                           QOrm::TransactionAction::Rollback);
+
+        upperAustria->setName(QString::fromUtf8("Upper Austria"));
+        QVERIFY(session.remove(upperAustria));
+        QVERIFY(!session.entityInstanceCache()->contains(upperAustria));
+    }
+
+    QVERIFY(session.entityInstanceCache()->contains(upperAustria));
+    QVERIFY(!session.entityInstanceCache()->isModified(upperAustria));
+    QCOMPARE(upperAustria->name(), QString::fromUtf8("Oberösterreich"));
+
+    auto result = session.from<Province>().select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector().size(), 1);
+    QCOMPARE(result.toVector().first(), upperAustria);
+}
+
 void SqliteSessionTest::testSchemaCreatedForReferencedEntities()
 {
     {
@@ -490,6 +1253,139 @@ void SqliteSessionTest::testRemoveInstance()
     QVERIFY(session.from<Province>().select().toVector().empty());
 }
 
+void SqliteSessionTest::testStatistics()
+{
+    QOrmSession session;
+    const QOrmSessionStatistics& statistics = session.statistics();
+
+    auto* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    auto* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+    upperAustria->setTowns({hagenberg});
+    QVERIFY(session.merge(hagenberg, upperAustria));
+
+    QOrmStatementStatistics creates = statistics.statementStatistics(QOrm::Operation::Create);
+    QCOMPARE(creates.statementCount(), quint64{2});
+    QCOMPARE(creates.rowCount(), quint64{2});
+    QCOMPARE(creates.executionLatency().count(), quint64{2});
+    QCOMPARE(statistics.statementStatistics(QOrm::Operation::Create, "Town").statementCount(),
+             quint64{1});
+    QVERIFY(statistics.classNames().contains("Province"));
+    QVERIFY(statistics.schemaSynchronizationCount() > 0);
+    QCOMPARE(statistics.commitLatency().count(), quint64{1});
+
+    session.resetStatistics();
+    QCOMPARE(statistics.statementStatistics(QOrm::Operation::Create).statementCount(),
+             quint64{0});
+    QVERIFY(statistics.classNames().isEmpty());
+
+    // the instance read is already known to the session
+    QCOMPARE(session.from<Town>().select().toVector(), QVector<Town*>{hagenberg});
+
+    QOrmStatementStatistics reads = statistics.statementStatistics(QOrm::Operation::Read, "Town");
+    QCOMPARE(reads.statementCount(), quint64{1});
+    QCOMPARE(reads.rowCount(), quint64{1});
+    QCOMPARE(reads.hydrationLatency().count(), quint64{1});
+    QCOMPARE(statistics.entityInstanceCacheHitCount(), quint64{1});
+    QCOMPARE(statistics.entityInstanceCacheMissCount(), quint64{0});
+    QCOMPARE(statistics.schemaSynchronizationCount(), quint64{0});
+}
+
+void SqliteSessionTest::testSlowQueryLog()
+{
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    sqliteConfiguration.setSlowQueryThreshold(0);
+    sqliteConfiguration.setLargeTableThreshold(1);
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+    QOrmSession session{sessionConfiguration};
+
+    QVERIFY(session.merge(new Province{QString::fromUtf8("Oberösterreich")},
+                          new Province{QString::fromUtf8("Niederösterreich")}));
+
+    // every statement takes longer than 0 ms: the unfiltered select scans the whole table
+    QTest::ignoreMessage(QtWarningMsg, "Full scan of large table Province with about 2 rows");
+    QCOMPARE(session.from<Province>().select().toVector().size(), 2);
+}
+
+void SqliteSessionTest::testTracing()
+{
+    QTemporaryDir traceDir;
+    QVERIFY(traceDir.isValid());
+    QString traceFileName = traceDir.filePath("trace.json");
+
+    QVERIFY(!QOrmTracer::isEnabled());
+    QVERIFY(QOrmTracer::start(traceFileName));
+    QVERIFY(QOrmTracer::isEnabled());
+
+    {
+        QOrmSession session;
+
+        auto* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+        QVERIFY(session.merge(upperAustria));
+        QCOMPARE(session.from<Province>().select().toVector().size(), 1);
+    }
+
+    QVERIFY(QOrmTracer::stop());
+    QVERIFY(!QOrmTracer::isEnabled());
+
+    QFile traceFile{traceFileName};
+    QVERIFY(traceFile.open(QFile::ReadOnly));
+
+    QJsonParseError parseError;
+    QJsonDocument trace = QJsonDocument::fromJson(traceFile.readAll(), &parseError);
+    QCOMPARE(parseError.error, QJsonParseError::NoError);
+
+    QSet<QString> eventNames;
+
+    for (const QJsonValue& event : trace.object()["traceEvents"].toArray())
+    {
+        QCOMPARE(event["ph"].toString(), QString{"X"});
+        QVERIFY(event["dur"].toDouble() >= 0.0);
+        eventNames.insert(event["name"].toString());
+    }
+
+    QVERIFY(eventNames.contains("merge"));
+    QVERIFY(eventNames.contains("beginTransaction"));
+    QVERIFY(eventNames.contains("commitTransaction"));
+    QVERIFY(eventNames.contains("synchronizeSchema"));
+    QVERIFY(eventNames.contains("prepare"));
+    QVERIFY(eventNames.contains("execute"));
+
+    // stopped tracers do not record
+    QVERIFY(!QOrmTracer::stop());
+
+    // a scope begun before the tracer was restarted belongs to the earlier tracing session
+    QVERIFY(QOrmTracer::start(traceFileName));
+
+    {
+        Q_ORM_TRACE_SCOPE("test", "stale");
+        QVERIFY(QOrmTracer::stop());
+        QVERIFY(QOrmTracer::start(traceFileName));
+
+        Q_ORM_TRACE_SCOPE_DETAIL("test", "first", QString{"detail"});
+        Q_ORM_TRACE_SCOPE_DETAIL("test", "second", QString{"detail"});
+    }
+
+    QVERIFY(QOrmTracer::stop());
+
+    traceFile.close();
+    QVERIFY(traceFile.open(QFile::ReadOnly));
+    trace = QJsonDocument::fromJson(traceFile.readAll(), &parseError);
+    QCOMPARE(parseError.error, QJsonParseError::NoError);
+
+    eventNames.clear();
+
+    for (const QJsonValue& event : trace.object()["traceEvents"].toArray())
+    {
+        QCOMPARE(event["args"]["detail"].toString(), QString{"detail"});
+        eventNames.insert(event["name"].toString());
+    }
+
+    QCOMPARE(eventNames, (QSet<QString>{"first", "second"}));
+}
+
 QTEST_GUILESS_MAIN(SqliteSessionTest)
 
 #include "tst_ormsession.moc"
@@ -22,6 +22,8 @@
 #include <QOrmFilter>
 #include <QOrmFilterExpression>
 #include <QOrmMetadataCache>
+#include <QOrmOrder>
+#include <QOrmQuery>
 #include <QOrmRelation>
 #include <QtTest>
 
@@ -44,6 +46,13 @@ private slots:
     void testInsertWithOneToMany();
     void testInsertWithOneToManyNullReference();
     void testFilterWithReference();
+    void testFilterWithIn();
+    void testFilterWithLargeIn();
+    void testFilterIsFlattened();
+    void testFilterConstantsAreFolded();
+    void testFilterWithPropertyPath();
+    void testNestedQueryIsFlattened();
+    void testDeeplyNestedQueryIsFlattened();
     void testUpdateWithManyToOne();
     void testUpdateWithOneToMany();
     void testUpdateWithOneToManyNullReference();
@@ -132,6 +141,221 @@ void SqliteStatementGenerator::testFilterWithReference()
     QCOMPARE(boundParameters[":province_id"], 1);
 }
 
+void SqliteStatementGenerator::testFilterWithIn()
+{
+    QOrmSqliteStatementGenerator generator;
+    QOrmMetadataCache cache;
+
+    QOrmFilter filter{
+        QOrmPrivate::resolvedFilterExpression(QOrmRelation{cache.get<Province>()},
+                                              Q_ORM_CLASS_PROPERTY(id).notIn(QVector<int>{1, 2}))};
+
+    QVariantMap boundParameters;
+    QString statement = generator.generateWhereClause(filter, boundParameters);
+
+    QCOMPARE(statement, "WHERE id NOT IN (:id, :id0)");
+    QCOMPARE(boundParameters[":id"], 1);
+    QCOMPARE(boundParameters[":id0"], 2);
+}
+
+void SqliteStatementGenerator::testFilterWithLargeIn()
+{
+    QOrmSqliteStatementGenerator generator;
+    QOrmMetadataCache cache;
+
+    QVector<int> ids;
+
+    for (int id = 0; id <= QOrmSqliteStatementGenerator::MaxInlineArraySize; ++id)
+        ids.push_back(id);
+
+    QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(QOrmRelation{cache.get<Province>()},
+                                                            Q_ORM_CLASS_PROPERTY(id).in(ids))};
+
+    QVariantMap boundParameters;
+    QString statement = generator.generateWhereClause(filter, boundParameters);
+
+    QCOMPARE(statement, "WHERE id IN (SELECT value FROM temp.qtorm_array_id)");
+    QCOMPARE(boundParameters.size(), 1);
+    QVERIFY(QOrmSqliteStatementGenerator::isArrayParameter(":qtorm_array_id"));
+    QCOMPARE(boundParameters[":qtorm_array_id"].toList().size(), ids.size());
+}
+
+void SqliteStatementGenerator::testFilterIsFlattened()
+{
+    QOrmSqliteStatementGenerator generator;
+    QOrmMetadataCache cache;
+
+    QOrmFilterExpression expression =
+        (Q_ORM_CLASS_PROPERTY(name) == QString{"Tirol"} && Q_ORM_CLASS_PROPERTY(id) > 1) &&
+        (Q_ORM_CLASS_PROPERTY(name) == QString{"Tirol"} || Q_ORM_CLASS_PROPERTY(id) == 2) &&
+        Q_ORM_CLASS_PROPERTY(name) == QString{"Tirol"};
+
+    QOrmFilter filter{
+        QOrmPrivate::resolvedFilterExpression(QOrmRelation{cache.get<Province>()}, expression)};
+
+    QCOMPARE(filter.expression()->type(), QOrm::FilterExpressionType::NaryPredicate);
+    QCOMPARE(filter.expression()->naryPredicate()->operands().size(), 3);
+
+    QVariantMap boundParameters;
+    QString statement = generator.generateWhereClause(filter, boundParameters);
+
+    QCOMPARE(statement, "WHERE name = :name AND id > :id AND (name = :name0 OR id = :id0)");
+    QCOMPARE(boundParameters.size(), 4);
+}
+
+void SqliteStatementGenerator::testFilterConstantsAreFolded()
+{
+    QOrmMetadataCache cache;
+    QOrmRelation relation{cache.get<Province>()};
+
+    QOrmFilterNaryPredicate alwaysTrue{QOrm::BinaryLogicalOperator::And, {}};
+    QOrmFilterNaryPredicate alwaysFalse{QOrm::BinaryLogicalOperator::Or, {}};
+
+    QOrmFilterExpression expression =
+        QOrmPrivate::resolvedFilterExpression(relation,
+                                              Q_ORM_CLASS_PROPERTY(id) == 1 || alwaysTrue);
+    QCOMPARE(QOrmPrivate::filterExpressionKey(expression),
+             QOrmPrivate::filterExpressionKey(alwaysTrue));
+
+    expression = QOrmPrivate::resolvedFilterExpression(relation,
+                                                       Q_ORM_CLASS_PROPERTY(id) == 1 && !alwaysTrue);
+    QCOMPARE(QOrmPrivate::filterExpressionKey(expression),
+             QOrmPrivate::filterExpressionKey(alwaysFalse));
+
+    expression = QOrmPrivate::resolvedFilterExpression(relation,
+                                                       Q_ORM_CLASS_PROPERTY(id) == 1 && alwaysTrue);
+    QCOMPARE(expression.type(), QOrm::FilterExpressionType::TerminalPredicate);
+
+    QVariantMap boundParameters;
+    QCOMPARE(QOrmSqliteStatementGenerator::generateWhereClause(QOrmFilter{alwaysTrue},
+                                                               boundParameters),
+             QString{});
+    QCOMPARE(QOrmSqliteStatementGenerator::generateWhereClause(QOrmFilter{alwaysFalse},
+                                                               boundParameters),
+             QString{"WHERE 0"});
+}
+
+void SqliteStatementGenerator::testFilterWithPropertyPath()
+{
+    QOrmSqliteStatementGenerator generator;
+    QOrmMetadataCache cache;
+    QOrmRelation relation{cache.get<Town>()};
+
+    QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(
+        relation,
+        Q_ORM_CLASS_PROPERTY(province.name) == QString{"Tirol"} ||
+            Q_ORM_CLASS_PROPERTY(name) == QString{"Hagenberg"})};
+
+    QOrmQuery query{QOrm::Operation::Read,
+                    relation,
+                    cache.get<Town>(),
+                    filter,
+                    {QOrmOrder{*cache.get<Town>().classPropertyMapping("name"),
+                               Qt::AscendingOrder}},
+                    QOrm::QueryFlags::None};
+
+    QVariantMap boundParameters;
+    QString statement = generator.generate(query, boundParameters);
+
+    QCOMPARE(statement,
+             "SELECT Town.* FROM Town "
+             "LEFT JOIN Province AS j_province ON j_province.id = Town.province_id "
+             "WHERE j_province.name = :j_province_name OR Town.name = :name "
+             "ORDER BY Town.name ASC");
+    QCOMPARE(boundParameters[":j_province_name"], QString{"Tirol"});
+    QCOMPARE(boundParameters[":name"], QString{"Hagenberg"});
+
+    boundParameters.clear();
+    statement = generator.generateDeleteStatement(cache.get<Town>(), filter, boundParameters);
+
+    QCOMPARE(statement,
+             "DELETE FROM Town WHERE id IN (SELECT Town.id FROM Town "
+             "LEFT JOIN Province AS j_province ON j_province.id = Town.province_id "
+             "WHERE j_province.name = :j_province_name OR Town.name = :name)");
+}
+
+void SqliteStatementGenerator::testNestedQueryIsFlattened()
+{
+    QOrmSqliteStatementGenerator generator;
+    QOrmMetadataCache cache;
+    const QOrmMetadata& town = cache.get<Town>();
+
+    QOrmQuery nested{QOrm::Operation::Read,
+                     QOrmRelation{town},
+                     town,
+                     QOrmFilter{QOrmPrivate::resolvedFilterExpression(
+                         QOrmRelation{town}, Q_ORM_CLASS_PROPERTY(name) == QString{"Linz"})},
+                     {QOrmOrder{*town.classPropertyMapping("name"), Qt::AscendingOrder}},
+                     QOrm::QueryFlags::None};
+
+    QOrmRelation relation{nested};
+    QOrmQuery query{QOrm::Operation::Read,
+                    relation,
+                    town,
+                    QOrmFilter{QOrmPrivate::resolvedFilterExpression(
+                        relation, Q_ORM_CLASS_PROPERTY(id) > 1)},
+                    {QOrmOrder{*town.classPropertyMapping("id"), Qt::DescendingOrder}},
+                    QOrm::QueryFlags::None,
+                    5};
+
+    QVariantMap boundParameters;
+    QString statement = generator.generate(QOrmQuery{QOrm::Operation::Read,
+                                                     QOrmRelation{query},
+                                                     town,
+                                                     std::nullopt,
+                                                     {},
+                                                     QOrm::QueryFlags::None,
+                                                     std::nullopt,
+                                                     2},
+                                           boundParameters);
+
+    // the nested limit cannot be merged into the outermost query
+    QCOMPARE(statement,
+             "SELECT * FROM (SELECT * FROM Town WHERE name = :name AND id > :id "
+             "ORDER BY id DESC,name ASC LIMIT 5) LIMIT -1 OFFSET 2");
+    QCOMPARE(boundParameters[":name"], QString{"Linz"});
+    QCOMPARE(boundParameters[":id"], 1);
+}
+
+void SqliteStatementGenerator::testDeeplyNestedQueryIsFlattened()
+{
+    QOrmSqliteStatementGenerator generator;
+    QOrmMetadataCache cache;
+    const QOrmMetadata& town = cache.get<Town>();
+
+    QOrmQuery innermost{QOrm::Operation::Read,
+                        QOrmRelation{town},
+                        town,
+                        QOrmFilter{QOrmPrivate::resolvedFilterExpression(
+                            QOrmRelation{town}, Q_ORM_CLASS_PROPERTY(name) == QString{"Linz"})},
+                        {},
+                        QOrm::QueryFlags::None};
+
+    QOrmQuery middle{QOrm::Operation::Read,
+                     QOrmRelation{innermost},
+                     town,
+                     std::nullopt,
+                     {QOrmOrder{*town.classPropertyMapping("name"), Qt::AscendingOrder}},
+                     QOrm::QueryFlags::None};
+
+    QOrmRelation relation{middle};
+    QOrmQuery query{QOrm::Operation::Read,
+                    relation,
+                    town,
+                    QOrmFilter{QOrmPrivate::resolvedFilterExpression(
+                        relation, Q_ORM_CLASS_PROPERTY(id) > 1)},
+                    {QOrmOrder{*town.classPropertyMapping("id"), Qt::DescendingOrder}},
+                    QOrm::QueryFlags::None};
+
+    QVariantMap boundParameters;
+    QString statement = generator.generate(query, boundParameters);
+
+    QCOMPARE(statement,
+             "SELECT * FROM Town WHERE name = :name AND id > :id ORDER BY id DESC,name ASC");
+    QCOMPARE(boundParameters[":name"], QString{"Linz"});
+    QCOMPARE(boundParameters[":id"], 1);
+}
+
 void SqliteStatementGenerator::testUpdateWithManyToOne()
 {
     QOrmSqliteStatementGenerator generator;
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "community.h"
+
+Community::Community(QObject* parent)
+    : QObject{parent}
+{
+}
+
+Community::Community(QString name,
+                     Province* province,
+                     QString postCode,
+                     int population,
+                     qreal latitude,
+                     qreal longitude,
+                     QObject* parent)
+    : QObject{parent}
+    , m_name{std::move(name)}
+    , m_province{province}
+    , m_postCode{std::move(postCode)}
+    , m_population{population}
+    , m_latitude{latitude}
+    , m_longitude{longitude}
+{
+}
+
+int Community::id() const
+{
+    return m_id;
+}
+
+void Community::setId(int id)
+{
+    if (m_id == id)
+        return;
+
+    m_id = id;
+    emit idChanged();
+}
+
+QString Community::name() const
+{
+    return m_name;
+}
+
+void Community::setName(QString name)
+{
+    if (m_name == name)
+        return;
+
+    m_name = name;
+    emit nameChanged();
+}
+
+Province* Community::province() const
+{
+    return m_province;
+}
+
+void Community::setProvince(Province* province)
+{
+    if (m_province == province)
+        return;
+
+    m_province = province;
+    emit provinceChanged();
+}
+
+QString Community::postCode() const
+{
+    return m_postCode;
+}
+
+void Community::setPostCode(QString postCode)
+{
+    if (m_postCode == postCode)
+        return;
+
+    m_postCode = postCode;
+    emit postCodeChanged();
+}
+
+int Community::population() const
+{
+    return m_population;
+}
+
+void Community::setPopulation(int population)
+{
+    if (m_population == population)
+        return;
+
+    m_population = population;
+    emit populationChanged();
+}
+
+qreal Community::longitude() const
+{
+    return m_longitude;
+}
+
+void Community::setLongitude(qreal longitude)
+{
+    if (qFuzzyCompare(m_longitude, longitude))
+        return;
+
+    m_longitude = longitude;
+    emit longitudeChanged();
+}
+
+qreal Community::latitude() const
+{
+    return m_latitude;
+}
+
+void Community::setLatitude(qreal latitude)
+{
+    if (qFuzzyCompare(m_latitude, latitude))
+        return;
+
+    m_latitude = latitude;
+    emit latitudeChanged();
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMMUNITY_H
+#define COMMUNITY_H
+
+#include <QObject>
+
+class Province;
+
+class Community : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int id READ id WRITE setId NOTIFY idChanged)
+    Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
+    Q_PROPERTY(Province* province READ province WRITE setProvince NOTIFY provinceChanged)
+    Q_PROPERTY(QString postCode READ postCode WRITE setPostCode NOTIFY postCodeChanged)
+    Q_PROPERTY(int population READ population WRITE setPopulation NOTIFY populationChanged)
+    Q_PROPERTY(qreal latitude READ latitude WRITE setLatitude NOTIFY latitudeChanged)
+    Q_PROPERTY(qreal longitude READ longitude WRITE setLongitude NOTIFY longitudeChanged)
+
+    int m_id{0};
+    QString m_name;
+    Province* m_province{nullptr};
+    QString m_postCode;
+    int m_population{0};
+    qreal m_latitude{0};
+    qreal m_longitude{0};
+
+public:
+    Q_INVOKABLE explicit Community(QObject* parent = nullptr);
+    explicit Community(QString name,
+                       Province* province,
+                       QString postCode,
+                       int population,
+                       qreal latitude,
+                       qreal longitude,
+                       QObject* parent = nullptr);
+
+    int id() const;
+    void setId(int id);
+
+    QString name() const;
+    void setName(QString name);
+
+    Province* province() const;
+    void setProvince(Province* province);
+
+    QString postCode() const;
+    void setPostCode(QString postCode);
+
+    int population() const;
+    void setPopulation(int population);
+
+    qreal latitude() const;
+    void setLatitude(qreal latitude);
+
+    qreal longitude() const;
+    void setLongitude(qreal longitude);
+
+public slots:
+
+signals:
+    void idChanged();
+    void nameChanged();
+    void provinceChanged();
+    void postCodeChanged();
+    void populationChanged();
+    void latitudeChanged();
+    void longitudeChanged();    
+};
+
+#endif // COMMUNITY_H
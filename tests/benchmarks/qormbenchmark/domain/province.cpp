@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "province.h"
+
+#include <QDebug>
+#include <QDebugStateSaver>
+
+QDebug operator<<(QDebug dbg, const Province& province)
+{
+    QDebugStateSaver saver{dbg};
+    dbg.noquote().nospace()
+        << "Province(" << province.id() << ", \"" << province.name() << "\")";
+    return dbg;
+}
+
+Province::Province(QObject* parent)
+    : QObject(parent)
+{
+}
+
+Province::Province(const QString& name, QObject* parent)
+    : QObject{parent}
+    , m_name{name}
+{
+}
+
+int Province::id() const
+{
+    return m_id;
+}
+
+QString Province::name() const
+{
+    return m_name;
+}
+
+void Province::setId(int id)
+{
+    if (m_id == id)
+    {
+        return;
+    }
+
+    m_id = id;
+    emit idChanged(m_id);
+}
+
+void Province::setName(QString name)
+{
+    if (m_name == name)
+        return;
+
+    m_name = name;
+    emit nameChanged(m_name);
+}
+
+QVector<Community*> Province::communityList() const
+{
+    return m_communityList;
+}
+
+void Province::setCommunityList(const QVector<Community*>& communityList)
+{
+    if (m_communityList == communityList)
+        return;
+
+    m_communityList = communityList;
+    emit communityListChanged();
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROVINCE_H
+#define PROVINCE_H
+
+#include <QObject>
+#include <QVector>
+
+class Community;
+
+class Province : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int id READ id WRITE setId NOTIFY idChanged)
+    Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
+    Q_PROPERTY(QVector<Community*> communityList READ communityList WRITE setCommunityList NOTIFY
+                   communityListChanged)
+
+    int m_id{0};
+    QString m_name;
+    QVector<Community*> m_communityList;
+
+public:
+    Q_INVOKABLE explicit Province(QObject* parent = nullptr);
+    explicit Province(const QString& name, QObject* parent = nullptr);
+
+    int id() const;
+    void setId(int id);
+
+    QString name() const;
+    void setName(QString name);
+
+    QVector<Community*> communityList() const;
+    void setCommunityList(const QVector<Community*>& communityList);
+
+signals:
+    void idChanged(int id);
+    void nameChanged(QString name);
+    void communityListChanged();
+};
+
+extern QDebug operator<<(QDebug dbg, const Province& province);
+
+#endif // PROVINCE_H
@@ -0,0 +1,13 @@
+QT = core testlib orm orm-private
+
+CONFIG += benchmark warn_on silent c++17
+
+TARGET = tst_ormbenchmark
+
+SOURCES +=  tst_ormbenchmark.cpp \
+    domain/community.cpp \
+    domain/province.cpp \
+
+HEADERS += \
+    domain/community.h \
+    domain/province.h \
@@ -0,0 +1,451 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include <QOrmEntityInstanceCache>
+#include <QOrmEntityListModel>
+#include <QOrmFilter>
+#include <QOrmMetadataCache>
+#include <QOrmOrder>
+#include <QOrmQuery>
+#include <QOrmRelation>
+#include <QOrmSession>
+#include <QOrmSqliteConfiguration>
+#include <QOrmSqliteProvider>
+
+#include "domain/community.h"
+#include "domain/province.h"
+
+#include "private/qormglobal_p.h"
+#include "private/qormsqlitestatementgenerator_p.h"
+
+#include <initializer_list>
+
+// Benchmarks of the ORM hot paths on the navigationdb domain. Most of them are data-driven by
+// the number of Community rows, which are spread evenly over the nine Austrian provinces.
+class OrmBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void generateInsertStatement();
+    void generateSelectStatement();
+
+    void insertSingle_data();
+    void insertSingle();
+    void insertTransactional_data();
+    void insertTransactional();
+
+    void selectWithoutReferences_data();
+    void selectWithoutReferences();
+    void selectWithReferences_data();
+    void selectWithReferences();
+
+    void entityInstanceCacheHit_data();
+    void entityInstanceCacheHit();
+
+    void entityListModelReset_data();
+    void entityListModelReset();
+
+    void rollback_data();
+    void rollback();
+
+private:
+    static void addRowCountData(std::initializer_list<int> rowCounts);
+    static QOrmSessionConfiguration sessionConfiguration(
+        const QString& databaseName,
+        QOrmSqliteConfiguration::SchemaMode schemaMode);
+
+    QString emptyDatabase();
+    QString populatedDatabase(int rowCount, bool hasProvinces);
+
+    QTemporaryDir m_databaseDir;
+    QHash<QPair<int, bool>, QString> m_populatedDatabases;
+    int m_databaseCounter{0};
+};
+
+static const char* const provinceNames[] = {"Burgenland",
+                                            "Kärnten",
+                                            "Niederösterreich",
+                                            "Oberösterreich",
+                                            "Salzburg",
+                                            "Steiermark",
+                                            "Tirol",
+                                            "Vorarlberg",
+                                            "Wien"};
+
+static QVector<Province*> createProvinces()
+{
+    QVector<Province*> provinces;
+
+    for (const char* name : provinceNames)
+        provinces.push_back(new Province{QString::fromUtf8(name)});
+
+    return provinces;
+}
+
+static Community* createCommunity(int index, Province* province)
+{
+    return new Community{QStringLiteral("Community %1").arg(index),
+                         province,
+                         QString::number(1000 + index % 9000),
+                         1000 + index,
+                         46.0 + (index % 300) / 100.0,
+                         9.5 + (index % 700) / 100.0};
+}
+
+// The back-reference list is filled in advance as merging validates both sides of a reference
+static QVector<Community*> createCommunities(Province* province, int count)
+{
+    QVector<Community*> communities;
+    communities.reserve(count);
+
+    for (int i = 0; i < count; ++i)
+        communities.push_back(createCommunity(i, province));
+
+    province->setCommunityList(communities);
+
+    return communities;
+}
+
+void OrmBenchmark::initTestCase()
+{
+    QVERIFY(m_databaseDir.isValid());
+
+    qRegisterOrmEntity<Province, Community>();
+}
+
+void OrmBenchmark::generateInsertStatement()
+{
+    QOrmMetadataCache cache;
+    const QOrmMetadata& metadata = cache.get<Community>();
+
+    Province upperAustria{QString::fromUtf8("Oberösterreich")};
+    upperAustria.setId(1);
+
+    QScopedPointer<Community> hagenberg{createCommunity(1, &upperAustria)};
+
+    QBENCHMARK
+    {
+        QVariantMap boundParameters;
+        QString statement = QOrmSqliteStatementGenerator::generateInsertStatement(metadata,
+                                                                                  hagenberg.get(),
+                                                                                  boundParameters);
+        Q_UNUSED(statement)
+    }
+}
+
+void OrmBenchmark::generateSelectStatement()
+{
+    QOrmMetadataCache cache;
+    const QOrmMetadata& community = cache.get<Community>();
+
+    QOrmRelation relation{community};
+    QOrmQuery query{QOrm::Operation::Read,
+                    relation,
+                    community,
+                    QOrmFilter{QOrmPrivate::resolvedFilterExpression(
+                        relation,
+                        Q_ORM_CLASS_PROPERTY(population) > 1000 &&
+                            Q_ORM_CLASS_PROPERTY(name) != QString::fromUtf8("Linz"))},
+                    {QOrmOrder{*community.classPropertyMapping("name"), Qt::AscendingOrder}},
+                    QOrm::QueryFlags::None,
+                    100};
+
+    QBENCHMARK
+    {
+        QVariantMap boundParameters;
+        QString statement = QOrmSqliteStatementGenerator::generate(query, boundParameters);
+        Q_UNUSED(statement)
+    }
+}
+
+void OrmBenchmark::insertSingle_data()
+{
+    addRowCountData({100, 1000});
+}
+
+// Without a transaction, SQLite commits every merge on its own
+void OrmBenchmark::insertSingle()
+{
+    QFETCH(int, rowCount);
+
+    QOrmSession session{
+        sessionConfiguration(emptyDatabase(), QOrmSqliteConfiguration::SchemaMode::Recreate)};
+
+    QBENCHMARK
+    {
+        auto* province = new Province{QString::fromUtf8("Oberösterreich")};
+
+        for (Community* community : createCommunities(province, rowCount))
+            QVERIFY(session.merge(community));
+    }
+}
+
+void OrmBenchmark::insertTransactional_data()
+{
+    addRowCountData({100, 1000, 10000});
+}
+
+void OrmBenchmark::insertTransactional()
+{
+    QFETCH(int, rowCount);
+
+    QOrmSession session{
+        sessionConfiguration(emptyDatabase(), QOrmSqliteConfiguration::SchemaMode::Recreate)};
+
+    QBENCHMARK
+    {
+        auto* province = new Province{QString::fromUtf8("Oberösterreich")};
+
+        QVERIFY(session.beginTransaction());
+
+        for (Community* community : createCommunities(province, rowCount))
+            QVERIFY(session.merge(community));
+
+        QVERIFY(session.commitTransaction());
+    }
+}
+
+void OrmBenchmark::selectWithoutReferences_data()
+{
+    addRowCountData({100, 1000, 10000});
+}
+
+// A new session per iteration starts with an empty entity instance cache, so that every row
+// is hydrated
+void OrmBenchmark::selectWithoutReferences()
+{
+    QFETCH(int, rowCount);
+
+    QString databaseName = populatedDatabase(rowCount, false);
+
+    QBENCHMARK
+    {
+        QOrmSession session{
+            sessionConfiguration(databaseName, QOrmSqliteConfiguration::SchemaMode::Bypass)};
+
+        QCOMPARE(session.from<Community>().select().toVector().size(), rowCount);
+    }
+}
+
+void OrmBenchmark::selectWithReferences_data()
+{
+    addRowCountData({100, 1000, 10000});
+}
+
+// Every community references its province, which is hydrated together with its community list
+// on the first occurrence
+void OrmBenchmark::selectWithReferences()
+{
+    QFETCH(int, rowCount);
+
+    QString databaseName = populatedDatabase(rowCount, true);
+
+    QBENCHMARK
+    {
+        QOrmSession session{
+            sessionConfiguration(databaseName, QOrmSqliteConfiguration::SchemaMode::Bypass)};
+
+        QCOMPARE(session.from<Community>().select().toVector().size(), rowCount);
+    }
+}
+
+void OrmBenchmark::entityInstanceCacheHit_data()
+{
+    addRowCountData({100, 1000, 10000});
+}
+
+void OrmBenchmark::entityInstanceCacheHit()
+{
+    QFETCH(int, rowCount);
+
+    QOrmSession session{sessionConfiguration(populatedDatabase(rowCount, true),
+                                             QOrmSqliteConfiguration::SchemaMode::Bypass)};
+
+    QVector<Community*> communities = session.from<Community>().select().toVector();
+    QCOMPARE(communities.size(), rowCount);
+
+    QVector<QVariant> objectIds;
+    objectIds.reserve(communities.size());
+
+    for (const Community* community : qAsConst(communities))
+        objectIds.push_back(community->id());
+
+    const QOrmMetadata& metadata = session.metadataCache()->get<Community>();
+    QOrmEntityInstanceCache* cache = session.entityInstanceCache();
+
+    QBENCHMARK
+    {
+        for (const QVariant& objectId : qAsConst(objectIds))
+            QVERIFY(cache->get(metadata, objectId) != nullptr);
+    }
+}
+
+void OrmBenchmark::entityListModelReset_data()
+{
+    addRowCountData({100, 1000, 10000});
+}
+
+// The instances are cached after the first read, so this is the cost of the query, the lookups
+// and the reset itself
+void OrmBenchmark::entityListModelReset()
+{
+    QFETCH(int, rowCount);
+
+    QOrmSession session{sessionConfiguration(populatedDatabase(rowCount, true),
+                                             QOrmSqliteConfiguration::SchemaMode::Bypass)};
+
+    QOrmEntityListModel<Community> model{session};
+    model.setOrder({QString::fromUtf8("name")});
+    QCOMPARE(model.rowCount(), rowCount);
+
+    QBENCHMARK
+    {
+        model.read();
+    }
+
+    QCOMPARE(model.rowCount(), rowCount);
+}
+
+void OrmBenchmark::rollback_data()
+{
+    addRowCountData({100, 1000});
+}
+
+// Rolled back instances are evicted from the session and restored, so the same ones are merged
+// again in the next iteration
+void OrmBenchmark::rollback()
+{
+    QFETCH(int, rowCount);
+
+    QOrmSession session{
+        sessionConfiguration(emptyDatabase(), QOrmSqliteConfiguration::SchemaMode::Recreate)};
+
+    auto* province = new Province{QString::fromUtf8("Oberösterreich")};
+    QVector<Community*> communities = createCommunities(province, rowCount);
+
+    QVERIFY(session.merge(province));
+
+    // the communities are not owned by the session after the rollback
+    QObject owner;
+
+    for (Community* community : qAsConst(communities))
+        community->setParent(&owner);
+
+    QBENCHMARK
+    {
+        QVERIFY(session.beginTransaction());
+
+        for (Community* community : qAsConst(communities))
+            QVERIFY(session.merge(community));
+
+        QVERIFY(session.rollbackTransaction());
+    }
+}
+
+void OrmBenchmark::addRowCountData(std::initializer_list<int> rowCounts)
+{
+    QTest::addColumn<int>("rowCount");
+
+    for (int rowCount : rowCounts)
+        QTest::newRow(QByteArray::number(rowCount).constData()) << rowCount;
+}
+
+QOrmSessionConfiguration
+OrmBenchmark::sessionConfiguration(const QString& databaseName,
+                                   QOrmSqliteConfiguration::SchemaMode schemaMode)
+{
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setDatabaseName(databaseName);
+    sqliteConfiguration.setSchemaMode(schemaMode);
+
+    return QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration}, false};
+}
+
+QString OrmBenchmark::emptyDatabase()
+{
+    return m_databaseDir.filePath(QStringLiteral("benchmark%1.db").arg(m_databaseCounter++));
+}
+
+// Databases are populated once and shared by the read-only benchmarks. Without provinces, the
+// communities have a null reference.
+QString OrmBenchmark::populatedDatabase(int rowCount, bool hasProvinces)
+{
+    auto it = m_populatedDatabases.find(qMakePair(rowCount, hasProvinces));
+
+    if (it != std::end(m_populatedDatabases))
+        return it.value();
+
+    QString databaseName = emptyDatabase();
+
+    QOrmSession session{
+        sessionConfiguration(databaseName, QOrmSqliteConfiguration::SchemaMode::Recreate)};
+
+    QVector<Province*> provinces = hasProvinces ? createProvinces() : QVector<Province*>{};
+    QVector<QVector<Community*>> communityLists(provinces.size());
+    QVector<Community*> communities;
+
+    for (int i = 0; i < rowCount; ++i)
+    {
+        if (provinces.isEmpty())
+        {
+            communities.push_back(createCommunity(i, nullptr));
+        }
+        else
+        {
+            int provinceIndex = i % provinces.size();
+            communities.push_back(createCommunity(i, provinces[provinceIndex]));
+            communityLists[provinceIndex].push_back(communities.back());
+        }
+    }
+
+    for (int i = 0; i < provinces.size(); ++i)
+        provinces[i]->setCommunityList(communityLists[i]);
+
+    if (!session.beginTransaction())
+        qFatal("Unable to populate the benchmark database");
+
+    for (Province* province : qAsConst(provinces))
+    {
+        if (!session.merge(province))
+            qFatal("Unable to populate the benchmark database");
+    }
+
+    for (Community* community : qAsConst(communities))
+    {
+        if (!session.merge(community))
+            qFatal("Unable to populate the benchmark database");
+    }
+
+    if (!session.commitTransaction())
+        qFatal("Unable to populate the benchmark database");
+
+    m_populatedDatabases.insert(qMakePair(rowCount, hasProvinces), databaseName);
+
+    return databaseName;
+}
+
+QTEST_GUILESS_MAIN(OrmBenchmark)
+
+#include "tst_ormbenchmark.moc"
@@ -1,4 +1,4 @@
 requires(qtHaveModule(orm))
 
 TEMPLATE = subdirs
-SUBDIRS += auto
+SUBDIRS += auto benchmarks